@@ -0,0 +1,51 @@
+/** @file ArbolFenwick.cc
+    @brief Código de la clase ArbolFenwick */
+
+#include "ArbolFenwick.hh"
+using namespace std;
+
+ArbolFenwick::ArbolFenwick() {
+    arbol.assign(2, 0);
+    num = 0;
+}
+
+void ArbolFenwick::sumar(int x, int d) {
+
+    // Se dobla el tamaño hasta que cabe x+1; el nuevo ultimo nodo cubre todo el rango,
+    // que es lo que cubria el ultimo nodo antiguo
+    int n = arbol.size() - 1;
+    while (x + 1 > n) {
+        arbol.resize(2*n + 1, 0);
+        arbol[2*n] = arbol[n];
+        n *= 2;
+    }
+    for (int i = x + 1; i <= n; i += i & -i) arbol[i] += d;
+    num += d;
+}
+
+int ArbolFenwick::total() const{
+    return num;
+}
+
+int ArbolFenwick::contar_menores(int x) const{
+    int n = arbol.size() - 1;
+    if (x > n) x = n;
+    int s = 0;
+    for (int i = x; i > 0; i -= i & -i) s += arbol[i];
+    return s;
+}
+
+int ArbolFenwick::kesimo(int k) const{
+
+    // Se baja por el arbol desde el salto mas grande buscando la ultima posicion
+    // con menos de k elementos hasta ella; el k-esimo esta en la siguiente
+    int n = arbol.size() - 1;
+    int pos = 0;
+    for (int salto = n; salto > 0; salto /= 2) {
+        if (pos + salto <= n and arbol[pos + salto] < k) {
+            pos += salto;
+            k -= arbol[pos];
+        }
+    }
+    return pos;
+}
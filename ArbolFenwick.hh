@@ -0,0 +1,71 @@
+/** @file ArbolFenwick.hh
+    @brief Especificación de la clase ArbolFenwick */
+
+#ifndef ARBOL_FENWICK_HH
+#define ARBOL_FENWICK_HH
+
+#ifndef NO_DIAGRAM
+#include <vector>
+#endif
+using namespace std;
+
+/** @class ArbolFenwick
+    @brief Representa un multiconjunto de enteros no negativos, que aquí son los puntos
+    de los jugadores.
+    Es un árbol de Fenwick indexado por valor: la posición i (de 1 a n) guarda cuántos
+    elementos hay con valor en (i - lowbit(i), i], desplazado en uno para que quepa el 0.
+    El tamaño n es siempre una potencia de 2 y se dobla cuando llega un valor que no
+    cabe; al doblar, los nodos antiguos no cambian y el único nodo nuevo no vacío es
+    el último, que cubre todo el rango.
+*/
+class ArbolFenwick {
+
+private:
+
+    /** @brief Nodos del árbol; arbol[0] no se usa */
+    vector<int> arbol;
+
+    /** @brief Número total de elementos */
+    int num;
+
+public:
+
+    // Constructor
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un multiconjunto vacío
+    */
+    ArbolFenwick();
+
+
+    // Modificador
+
+    /** @brief Se añaden o se quitan elementos con un valor
+        \pre x >= 0, y si d < 0 hay al menos -d elementos con valor x
+        \post Se han añadido d elementos con valor x (o quitado -d si d es negativo)
+    */
+    void sumar(int x, int d);
+
+
+    // Consultores
+
+    /** @brief Consultor del número de elementos
+        \pre <em>Cierto</em>
+        \post El resultado es el número de elementos del multiconjunto
+    */
+    int total() const;
+
+    /** @brief Cuenta los elementos menores que un valor
+        \pre <em>Cierto</em>
+        \post El resultado es el número de elementos con valor menor que x
+    */
+    int contar_menores(int x) const;
+
+    /** @brief Consulta el k-ésimo elemento más pequeño
+        \pre 1 <= k <= total()
+        \post El resultado es el valor del k-ésimo elemento en orden creciente
+    */
+    int kesimo(int k) const;
+};
+#endif
@@ -0,0 +1,393 @@
+/** @file ArchivoCuadros.cc
+    @brief Código de la clase ArchivoCuadros */
+
+#include "ArchivoCuadros.hh"
+#ifndef NO_DIAGRAM
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+using namespace std;
+
+const char ArchivoCuadros::MAGIA[4] = {'\0', 'C', 'U', '1'};
+const unsigned char ArchivoCuadros::NOMBRE;
+const unsigned char ArchivoCuadros::CUADRO;
+
+// Bytes de la cabecera: MAGIA y los bytes ocupados
+static const size_t CABECERA = 12;
+
+// Bytes con los que empieza una proyeccion
+static const size_t CAPACIDAD_INICIAL = 1 << 16;
+
+// Lee un varint a partir de p[i] y deja 'i' detras de el
+static unsigned int leer_natural(const unsigned char* p, size_t& i) {
+    unsigned int x = 0;
+    int d = 0;
+    while (p[i] & 0x80) {
+        x |= (unsigned int)(p[i++] & 0x7f) << d;
+        d += 7;
+    }
+    x |= (unsigned int)p[i++] << d;
+    return x;
+}
+
+// Lee y escribe enteros de 'n' bytes en little endian
+static unsigned long long leer_fijo(const unsigned char* p, int n) {
+    unsigned long long x = 0;
+    for (int i = n-1; i >= 0; --i) x = x << 8 | p[i];
+    return x;
+}
+
+static void escribir_fijo(unsigned char* p, unsigned long long x, int n) {
+    for (int i = 0; i < n; ++i) {
+        p[i] = x & 0xff;
+        x >>= 8;
+    }
+}
+
+// Escribe el entero x en "buf" (igual que en Torneo)
+static void escribir_entero(string& buf, int x) {
+    char tmp[12];
+    int n = 0;
+    do {
+        tmp[n++] = char('0' + x%10);
+        x /= 10;
+    } while (x > 0);
+    while (n > 0) buf += tmp[--n];
+}
+
+
+// Funciones privadas
+
+void ArchivoCuadros::anadir_natural(unsigned int x) {
+    while (x >= 0x80) {
+        reg += char((x & 0x7f) | 0x80);
+        x >>= 7;
+    }
+    reg += char(x);
+}
+
+int ArchivoCuadros::identificador(const string& nom) {
+    map<string, int>::const_iterator it = ident.find(nom);
+    if (it != ident.end()) return it->second;
+    if (anadir_registro(char(NOMBRE) + nom) == 0) return -1;
+    int h = nombres.size();
+    ident[nom] = h;
+    nombres.push_back(nom);
+    return h;
+}
+
+size_t ArchivoCuadros::anadir_registro(const string& contenido) {
+    size_t n = contenido.size();
+    if (not reservar(usados + 4 + n)) return 0;
+
+    // Primero se escribe el registro y despues los bytes ocupados, asi que un archivo
+    // interrumpido a medias sigue acabando en el ultimo registro entero
+    size_t p = usados + 4;
+    escribir_fijo(datos + usados, n, 4);
+    memcpy(datos + p, contenido.data(), n);
+    usados = p + n;
+    escribir_fijo(datos + 4, usados, 8);
+    return p;
+}
+
+bool ArchivoCuadros::reservar(size_t n) {
+    if (n <= capacidad) return true;
+    size_t nueva = max(capacidad, CAPACIDAD_INICIAL);
+    while (nueva < n) nueva *= 2;
+
+    unsigned char* p;
+    if (fd == -1) {
+        p = (unsigned char*)mmap(NULL, nueva, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return false;
+        if (datos == NULL) memcpy(p, MAGIA, 4);
+        else {
+            memcpy(p, datos, usados);
+            munmap(datos, capacidad);
+        }
+    }
+    else {
+        if (ftruncate(fd, nueva) != 0) return false;
+        p = (unsigned char*)mmap(NULL, nueva, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        munmap(datos, capacidad);
+    }
+    datos = p;
+    capacidad = nueva;
+    return true;
+}
+
+void ArchivoCuadros::indexar(size_t p, size_t n) {
+    if (datos[p] == NOMBRE) {
+        string nom((const char*)datos + p + 1, n - 1);
+        ident[nom] = nombres.size();
+        nombres.push_back(nom);
+    }
+    else if (datos[p] == CUADRO) {
+        size_t i = p + 1;
+        ediciones[leer_natural(datos, i)].push_back(p);
+    }
+}
+
+void ArchivoCuadros::cerrar() {
+    if (datos != NULL) munmap(datos, capacidad);
+    if (fd != -1) {
+        if (ftruncate(fd, usados) != 0) {}
+        close(fd);
+    }
+    fd = -1;
+    datos = NULL;
+    capacidad = usados = 0;
+    ident.clear();
+    nombres.clear();
+    ediciones.clear();
+}
+
+
+// Funciones publicas
+
+ArchivoCuadros::ArchivoCuadros() {
+    fd = -1;
+    capacidad = CAPACIDAD_INICIAL;
+    datos = (unsigned char*)mmap(NULL, capacidad, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (datos == MAP_FAILED) {
+        datos = NULL;
+        capacidad = 0;
+    }
+    else {
+        memcpy(datos, MAGIA, 4);
+        escribir_fijo(datos + 4, CABECERA, 8);
+    }
+    usados = CABECERA;
+}
+
+ArchivoCuadros::~ArchivoCuadros() {
+    cerrar();
+}
+
+bool ArchivoCuadros::abrir(const string& ruta) {
+    int f = open(ruta.c_str(), O_RDWR | O_CREAT, 0644);
+    if (f < 0) return false;
+    struct stat st;
+    if (fstat(f, &st) != 0) {
+        close(f);
+        return false;
+    }
+
+    // Un fichero que no esta vacio tiene que empezar por la cabecera de un archivo
+    size_t tam = st.st_size;
+    unsigned char cab[CABECERA];
+    if (tam > 0 and (tam < CABECERA or pread(f, cab, CABECERA, 0) != (ssize_t)CABECERA
+                     or memcmp(cab, MAGIA, 4) != 0 or leer_fijo(cab + 4, 8) > tam)) {
+        close(f);
+        return false;
+    }
+    size_t ocupados = tam > 0 ? leer_fijo(cab + 4, 8) : CABECERA;
+
+    size_t cap = CAPACIDAD_INICIAL;
+    while (cap < ocupados) cap *= 2;
+    if (ftruncate(f, cap) != 0) {
+        close(f);
+        return false;
+    }
+    unsigned char* p = (unsigned char*)mmap(NULL, cap, PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+    if (p == MAP_FAILED) {
+        close(f);
+        return false;
+    }
+
+    cerrar();
+    fd = f;
+    datos = p;
+    capacidad = cap;
+    usados = ocupados;
+    if (tam == 0) {
+        memcpy(datos, MAGIA, 4);
+        escribir_fijo(datos + 4, usados, 8);
+    }
+
+    // Solo se leen las longitudes y los primeros bytes de cada registro
+    size_t i = CABECERA;
+    while (i + 4 <= usados) {
+        size_t n = leer_fijo(datos + i, 4);
+        if (n == 0 or i + 4 + n > usados) break;
+        indexar(i + 4, n);
+        i += 4 + n;
+    }
+    return true;
+}
+
+bool ArchivoCuadros::archivar(const string& id_to, const vector<Jugador>& part, const vector<int>& a,
+                              const vector<int>& der, const LoteResultados& lote) {
+
+    // Los registros de los nombres nuevos van delante del de la edicion
+    int h_to = identificador(id_to);
+    if (h_to == -1) return false;
+    int m = part.size();
+    vector<int> h_jug(m);
+    for (int i = 0; i < m; ++i) {
+        h_jug[i] = identificador(part[i].consultar_nombre());
+        if (h_jug[i] == -1) return false;
+    }
+
+    reg.clear();
+    reg += char(CUADRO);
+    anadir_natural(h_to);
+    int n = der.size();
+    anadir_natural(n);
+
+    // Forma: cada nodo abre un parentesis, y lo cierra despues de sus hijos; en
+    // "pendientes" hay cuantos hijos quedan por cerrar de cada nodo abierto
+    string bits((2*n + 7)/8, '\0');
+    int k = 0;
+    vector<int> pendientes;
+    for (int i = 0; i < n; ++i) {
+        bits[k/8] |= char(1 << (k%8));
+        ++k;
+        if (der[i] != -1) pendientes.push_back(2);
+        else {
+            ++k;
+            while (not pendientes.empty() and --pendientes.back() == 0) {
+                ++k;
+                pendientes.pop_back();
+            }
+        }
+    }
+    reg += bits;
+
+    // Cabezas de serie: la de cada hoja es el jugador que llega a ella
+    anadir_natural(m);
+    for (int i = 0; i < m; ++i) anadir_natural(h_jug[i]);
+    for (int i = 0; i < n; ++i) if (der[i] == -1) anadir_natural(a[i]);
+
+    // Ganadores, un bit por partido
+    string gana;
+    int p = 0;
+    for (int i = 0; i < n; ++i) {
+        if (der[i] != -1) {
+            if (p%8 == 0) gana += '\0';
+            if (a[i] == a[i+1]) gana[p/8] |= char(1 << (p%8));
+            ++p;
+        }
+    }
+    reg += gana;
+
+    // Puntuaciones: 2s + t, los s sets en un byte cada uno y, si t es 1, el texto
+    string canonico;
+    for (int i = 0; i < n; ++i) {
+        if (der[i] != -1) {
+            const string& t = lote.texto(i);
+            int s = lote.numero_sets(i);
+            canonico.clear();
+            for (int j = 0; j < s; ++j) {
+                if (j > 0) canonico += ',';
+                canonico += char('0' + lote.set(i, j).primer());
+                canonico += '-';
+                canonico += char('0' + lote.set(i, j).segon());
+            }
+            bool texto = canonico != t;
+            anadir_natural(2*s + (texto ? 1 : 0));
+            for (int j = 0; j < s; ++j) reg += char(lote.set(i, j).primer() << 4 | lote.set(i, j).segon());
+            if (texto) {
+                anadir_natural(t.size());
+                reg += t;
+            }
+        }
+    }
+
+    size_t pos = anadir_registro(reg);
+    if (pos == 0) return false;
+    ediciones[h_to].push_back(pos);
+    return true;
+}
+
+int ArchivoCuadros::numero_ediciones(const string& id_to) const {
+    map<string, int>::const_iterator it = ident.find(id_to);
+    if (it == ident.end()) return 0;
+    map<int, vector<size_t> >::const_iterator ed = ediciones.find(it->second);
+    return ed == ediciones.end() ? 0 : ed->second.size();
+}
+
+void ArchivoCuadros::escribir_cuadro(const string& id_to, int ed, ostream& os) const {
+    size_t i = ediciones.find(ident.find(id_to)->second)->second[ed-1] + 1;
+    leer_natural(datos, i);
+    int n = leer_natural(datos, i);
+
+    // Se rehacen los hijos derechos a partir de los parentesis: un nodo que se abre es
+    // el hijo derecho de su padre si este ya tenia otro
+    const unsigned char* bits = datos + i;
+    i += (2*n + 7)/8;
+    vector<int> der(n, -1);
+    vector<pair<int, int> > abiertos;
+    int nodo = 0;
+    for (int k = 0; k < 2*n; ++k) {
+        if (bits[k/8] >> (k%8) & 1) {
+            if (not abiertos.empty() and ++abiertos.back().second == 2) der[abiertos.back().first] = nodo;
+            abiertos.push_back(make_pair(nodo, 0));
+            ++nodo;
+        }
+        else abiertos.pop_back();
+    }
+    int m = leer_natural(datos, i);
+    vector<int> h_jug(m);
+    for (int j = 0; j < m; ++j) h_jug[j] = leer_natural(datos, i);
+    vector<int> a(n);
+    for (int j = 0; j < n; ++j) if (der[j] == -1) a[j] = leer_natural(datos, i);
+
+    // Ganadores, de abajo arriba como en Torneo::proc_resultados
+    vector<int> partido(n, -1);
+    int p = 0;
+    for (int j = 0; j < n; ++j) if (der[j] != -1) partido[j] = p++;
+    const unsigned char* gana = datos + i;
+    i += (p + 7)/8;
+    for (int j = n-1; j >= 0; --j)
+        if (der[j] != -1) a[j] = (gana[partido[j]/8] >> (partido[j]%8) & 1) ? a[j+1] : a[der[j]];
+
+    // Se escribe como Torneo::imprimir_resultados
+    vector<int> fin(n);
+    for (int j = n-1; j >= 0; --j) fin[j] = (der[j] == -1) ? j+1 : fin[der[j]];
+    string buf;
+    vector<int> pila;
+    for (int j = 0; j < n; ++j) {
+        while (not pila.empty() and pila.back() <= j) {
+            buf += ')';
+            pila.pop_back();
+        }
+        if (der[j] != -1) {
+            int x = a[j+1], y = a[der[j]];
+            buf += '(';
+            escribir_entero(buf, x);
+            buf += '.';
+            buf += nombres[h_jug[x-1]];
+            buf += " vs ";
+            escribir_entero(buf, y);
+            buf += '.';
+            buf += nombres[h_jug[y-1]];
+            buf += ' ';
+
+            unsigned int cab = leer_natural(datos, i);
+            int s = cab/2;
+            if (cab%2 == 1) {
+                i += s;
+                int lon = leer_natural(datos, i);
+                buf.append((const char*)datos + i, lon);
+                i += lon;
+            }
+            else {
+                for (int q = 0; q < s; ++q) {
+                    if (q > 0) buf += ',';
+                    buf += char('0' + (datos[i] >> 4));
+                    buf += '-';
+                    buf += char('0' + (datos[i] & 0xf));
+                    ++i;
+                }
+            }
+            pila.push_back(fin[j]);
+        }
+    }
+    buf.append(pila.size(), ')');
+    os.write(buf.data(), buf.size());
+}
@@ -0,0 +1,164 @@
+/** @file ArchivoCuadros.hh
+    @brief Especificación de la clase ArchivoCuadros */
+
+#ifndef ARCHIVO_CUADROS_HH
+#define ARCHIVO_CUADROS_HH
+
+#include "Jugador.hh"
+#include "LoteResultados.hh"
+
+#ifndef NO_DIAGRAM
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#endif
+using namespace std;
+
+/** @class ArchivoCuadros
+    @brief Archivo de solo añadir con los cuadros de resultados de todas las ediciones
+    finalizadas. Vive en una proyección en memoria de un fichero (o, si no se ha abierto
+    ninguno, de memoria anónima) que empieza por MAGIA y por los bytes ocupados en 8 bytes
+    (little endian), que solo se actualizan cuando un registro ya está entero, seguidos de
+    registros con su longitud en 4 bytes (little endian) delante:
+    - Un registro que empieza por el byte NOMBRE define el siguiente identificador
+      (0, 1, 2...), que es el resto del registro: un nombre de torneo o de jugador.
+    - Un registro que empieza por el byte CUADRO es una edición: el identificador del
+      torneo, el número n de nodos del cuadro, su forma como 2n bits de paréntesis
+      equilibrados en preorden (1 abre y 0 cierra, empezando por el bit bajo de cada
+      byte), el número m de participantes, el identificador del jugador de cada número
+      de cabeza de serie, la cabeza de serie de cada hoja en preorden, un bit por partido
+      que indica si gana el primer jugador y la puntuación de cada partido, codificada
+      como los resultados de <em>EscritorBinario</em>.
+    Los enteros van en varint. Al abrir un fichero solo se recorren las cabeceras de sus
+    registros para indexar las ediciones; cada consulta decodifica solo su registro.
+*/
+class ArchivoCuadros {
+
+private:
+
+    /** @brief Descriptor del fichero, o -1 si la proyección es anónima */
+    int fd;
+
+    /** @brief Proyección, bytes proyectados y bytes ocupados */
+    unsigned char* datos;
+    size_t capacidad;
+    size_t usados;
+
+    /** @brief Identificador de cada nombre definido, con el nombre como clave, y nombre de cada identificador */
+    map<string, int> ident;
+    vector<string> nombres;
+
+    /** @brief Posición de cada edición archivada de cada torneo, en orden, con el identificador del torneo como clave */
+    map<int, vector<size_t> > ediciones;
+
+    /** @brief Registro que se está formando */
+    string reg;
+
+    /** @brief Función privada que añade un natural al registro
+        \pre <em>Cierto</em>
+        \post Se ha añadido 'x' al final de "reg" en varint
+    */
+    void anadir_natural(unsigned int x);
+
+    /** @brief Función privada que obtiene el identificador de un nombre
+        \pre <em>Cierto</em>
+        \post El resultado es el identificador de "nom"; si no tenía, se le ha asignado
+        el siguiente y se ha añadido al archivo el registro que lo define. Si no se ha
+        podido añadir, el resultado es -1
+    */
+    int identificador(const string& nom);
+
+    /** @brief Función privada que añade un registro al archivo
+        \pre <em>Cierto</em>
+        \post Se ha añadido "contenido" precedido de su longitud al final del archivo y
+        se han actualizado los bytes ocupados, si se ha podido ampliar la proyección. El
+        resultado es la posición del contenido, o 0 si no se ha podido
+    */
+    size_t anadir_registro(const string& contenido);
+
+    /** @brief Función privada que amplía la proyección
+        \pre <em>Cierto</em>
+        \post La proyección tiene al menos 'n' bytes. El resultado indica si se ha podido
+    */
+    bool reservar(size_t n);
+
+    /** @brief Función privada que indexa un registro existente
+        \pre En la posición 'p' de la proyección empieza el contenido de un registro de 'n' bytes
+        \post Se ha añadido el registro al índice de nombres o de ediciones
+    */
+    void indexar(size_t p, size_t n);
+
+    /** @brief Función privada que libera la proyección
+        \pre <em>Cierto</em>
+        \post Se ha deshecho la proyección y, si había un fichero, se ha recortado a los
+        bytes ocupados y se ha cerrado
+    */
+    void cerrar();
+
+public:
+
+    /** @brief Marca del principio del archivo */
+    static const char MAGIA[4];
+
+    /** @brief Primer byte de los registros que definen un identificador y de los de una edición */
+    static const unsigned char NOMBRE = 0xFF;
+    static const unsigned char CUADRO = 0x01;
+
+    // Constructores
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un archivo vacío en memoria anónima
+    */
+    ArchivoCuadros();
+
+    ArchivoCuadros(const ArchivoCuadros&) = delete;
+    ArchivoCuadros& operator=(const ArchivoCuadros&) = delete;
+
+
+    // Destructor
+
+    ~ArchivoCuadros();
+
+
+    // Modificadores
+
+    /** @brief Se pasa a usar un fichero como archivo
+        \pre <em>Cierto</em>
+        \post Si "ruta" no existe o está vacío, se ha creado con un archivo vacío; si ya
+        era un archivo, se han indexado sus ediciones. Lo archivado hasta ahora en memoria
+        se pierde. El resultado indica si se ha podido; si no, se sigue en memoria anónima
+    */
+    bool abrir(const string& ruta);
+
+    /** @brief Se archiva una edición finalizada de un torneo
+        \pre "part" son los participantes de la edición del torneo "id_to", "lote" sus
+        resultados en preorden, "der" la forma de los resultados y 'a' el resultado de
+        <em>proc_resultados</em>
+        \post Si se ha podido ampliar el archivo, se ha añadido al final el registro de la
+        edición. El resultado indica si se ha añadido
+    */
+    bool archivar(const string& id_to, const vector<Jugador>& part, const vector<int>& a,
+                  const vector<int>& der, const LoteResultados& lote);
+
+
+    // Consultor
+
+    /** @brief Consulta el número de ediciones archivadas de un torneo
+        \pre <em>Cierto</em>
+        \post El resultado es el número de ediciones del torneo "id_to" que hay en el archivo
+    */
+    int numero_ediciones(const string& id_to) const;
+
+
+    // Escritura
+
+    /** @brief Operación de escritura de una edición archivada
+        \pre 1 <= "ed" <= <em>numero_ediciones</em>(id_to)
+        \post Se ha escrito a través del canal "os" el cuadro de resultados de la
+        edición "ed" del torneo "id_to", igual que al finalizarla
+    */
+    void escribir_cuadro(const string& id_to, int ed, ostream& os) const;
+};
+#endif
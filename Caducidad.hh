@@ -0,0 +1,42 @@
+/** @file Caducidad.hh
+    @brief Especificación del registro Caducidad */
+
+#ifndef CADUCIDAD_HH
+#define CADUCIDAD_HH
+
+#ifndef NO_DIAGRAM
+#include <string>
+#endif
+using namespace std;
+
+/** @struct Caducidad
+    @brief Representa la caducidad de los puntos que ha conseguido un participante en una
+    edición de un torneo.
+    Las caducidades se ordenan por semana y, dentro de la misma semana, por edición y
+    por participante, para que caduquen siempre en el mismo orden.
+*/
+struct Caducidad {
+
+    /** @brief Semana del reloj del circuito en la que caducan los puntos */
+    int semana;
+
+    /** @brief Número de la edición en la que se consiguieron los puntos */
+    int edicion;
+
+    /** @brief Identificador del torneo */
+    string torneo;
+
+    /** @brief Número del participante dentro de la edición */
+    int participante;
+
+    /** @brief Operación de comparación
+        \pre <em>Cierto</em>
+        \post El resultado indica si el parámetro implícito caduca después que "c"
+    */
+    bool operator>(const Caducidad& c) const {
+        if (semana != c.semana) return semana > c.semana;
+        if (edicion != c.edicion) return edicion > c.edicion;
+        return participante > c.participante;
+    }
+};
+#endif
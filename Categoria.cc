@@ -6,16 +6,19 @@ using namespace std;
 
 Categoria::Categoria() {
     id = 0;
+    formato = CLASICO;
 }
 
-Categoria::Categoria(string& id_cat) {
+Categoria::Categoria(string id_cat) {
     id = 0;
-    name = id_cat;
+    name = move(id_cat);
+    formato = CLASICO;
 }
 
-Categoria::Categoria(string& id_cat, int x) {
-    name = id_cat;
+Categoria::Categoria(string id_cat, int x) {
+    name = move(id_cat);
     id = x;
+    formato = CLASICO;
 }
 
 void Categoria::asignar_puntos(int k) {
@@ -26,20 +29,42 @@ void Categoria::asignar_puntos(int k) {
     }
 }
 
-string Categoria::consultar_nombre_categoria() const{
+void Categoria::definir_formato(Formato f) {
+    formato = f;
+}
+
+const string& Categoria::consultar_nombre_categoria() const{
     return name;
 }
 
-int Categoria::consultar_puntos(int nivel) {
-    return ptos_por_nivel[nivel];
+int Categoria::consultar_id() const{
+    return id;
+}
+
+int Categoria::consultar_puntos(int nivel) const{
+    map<int, int>::const_iterator it = ptos_por_nivel.find(nivel);
+    if (it != ptos_por_nivel.end()) return it->second;
+    else return 0;
+}
+
+Categoria::Formato Categoria::consultar_formato() const{
+    return formato;
+}
+
+bool Categoria::leer_formato(const string& nom, Formato& f) {
+    if (nom == "clasico") f = CLASICO;
+    else if (nom == "mejor_de_3") f = MEJOR_DE_3;
+    else if (nom == "mejor_de_5") f = MEJOR_DE_5;
+    else return false;
+    return true;
 }
 
-void Categoria::listar_categoria(int k) {
-    cout << name << ' ';
+void Categoria::listar_categoria(int k, ostream& os) {
+    os << name << ' ';
     for (int i = 1; i < k; ++i) {
-        cout << ptos_por_nivel[i] << ' ';
+        os << ptos_por_nivel[i] << ' ';
     }
-    cout << ptos_por_nivel[k] << endl;
+    os << ptos_por_nivel[k] << endl;
 }
 
 
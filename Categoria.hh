@@ -17,14 +17,25 @@ using namespace std;
     La categoria se puede identificar con un string (name) o con un entero entre 1 y c (id),
     donde c es el numero de categorias del circuito.
     También contiene un map con un entero como clave (nivel) y un entero que representa
-    los puntos pertenecientes al nivel
+    los puntos pertenecientes al nivel, y el formato con el que se interpretan los
+    resultados de los partidos de sus torneos (ver <em>Marcador</em>)
 */
 class Categoria {
+
+public:
+
+    /** @brief Formatos de los partidos */
+    enum Formato {
+        CLASICO,
+        MEJOR_DE_3,
+        MEJOR_DE_5
+    };
     
 private:
 
     int id;
     string name;
+    Formato formato;
 
     /** @brief map con un entero como clave que representa el nivel y otro entero como valor que representa
         los puntos que corresponden a este nivel dentro de esta categoría */
@@ -47,7 +58,7 @@ public:
         \pre <em>Cierto</em>
         \post El resultado es una Categoria inicializada con un string como nombre
     */
-    Categoria(string& id_cat);
+    Categoria(string id_cat);
     
      /** @brief Creadora por defecto
          Se genera una Categoria automáticamente al declararse con nombre
@@ -56,7 +67,7 @@ public:
          \post El resultado es una Categoria inicializada con un string como nombre
          y un entero que representa su identificador
     */
-    Categoria(string& id_cat, int x);
+    Categoria(string id_cat, int x);
     
     
     // Modificador
@@ -67,6 +78,12 @@ public:
         los puntos pertenecientes
     */
     void asignar_puntos(int k);
+
+    /** @brief Se cambia el formato de los partidos de la Categoria
+        \pre <em>Cierto</em>
+        \post Los resultados de los torneos de la Categoria se interpretan con el formato "f"
+    */
+    void definir_formato(Formato f);
     
 
     // Consultor
@@ -75,24 +92,44 @@ public:
         \pre Categoria inicializada
         \post Se ha devuelto un string que representa el nombre de la Categoria
     */
-    string consultar_nombre_categoria() const;
+    const string& consultar_nombre_categoria() const;
+
+    /** @brief Consultor del identificador de la Categoria
+        \pre Categoria inicializada
+        \post Se ha devuelto el entero que identifica a la Categoria
+    */
+    int consultar_id() const;
 
     /** @brief Consultor de los puntos de la Categoría en un nivel determinado
         \pre Categoria inicializada y puntos de cada nivel leídos
         \post Se han devuelto los puntos pertenecientes al nivel de la Categoria
         pasado como parámetro
     */
-    int consultar_puntos(int nivel);
+    int consultar_puntos(int nivel) const;
+
+    /** @brief Consultor del formato de los partidos de la Categoria
+        \pre <em>Cierto</em>
+        \post El resultado es el formato con el que se interpretan los resultados de
+        los partidos de los torneos de la Categoria
+    */
+    Formato consultar_formato() const;
+
+    /** @brief Traduce el nombre de un formato
+        \pre <em>Cierto</em>
+        \post Si "nom" es "clasico", "mejor_de_3" o "mejor_de_5", 'f' es el formato
+        correspondiente y el resultado es cierto; si no, el resultado es falso
+    */
+    static bool leer_formato(const string& nom, Formato& f);
 
 
     // Escritura
     
     /** @brief Se lista el nombre y la tabla de puntos por niveles de la Categoria
         \pre Categoria inicializada
-        \post Se ha escrito a través del canal estandar de salida el nombre y 
+        \post Se ha escrito a través del canal "os" el nombre y 
         la tabla de puntos por niveles de la Categoria
     */
-    void listar_categoria(int k);
+    void listar_categoria(int k, ostream& os);
 };
 #endif
     
@@ -0,0 +1,618 @@
+/** @file Circuito.cc
+    @brief Código de la clase Circuito */
+
+#include "Circuito.hh"
+#include "Pronostico.hh"
+#include "RankingProvisional.hh"
+#include "Traza.hh"
+#ifndef NO_DIAGRAM
+#include <cmath>
+#include <chrono>
+#include <iomanip>
+#endif
+using namespace std;
+
+// Funciones privadas
+
+void Circuito::ranking_cambiado(const string& id_to, bool final) {
+    torneo_pendiente = id_to;
+    final_pendiente = final;
+    ranking_pendiente = true;
+    if (lote_abierto) jugadores.aplazar_ranking();
+    else poner_al_dia_ranking();
+}
+
+void Circuito::poner_al_dia_ranking() {
+    if (ranking_pendiente) {
+        jugadores.actualizar_ranking();
+        historial.registrar(jugadores, torneo_pendiente, final_pendiente);
+        ranking_pendiente = false;
+    }
+}
+
+
+// Funciones publicas
+
+Circuito::Circuito() {
+    c = 0;
+    k = 0;
+    semana = 0;
+    ventana = 0;
+    lote_abierto = false;
+    ranking_pendiente = false;
+    final_pendiente = false;
+}
+
+void Circuito::ejecutar(const Comando& com, ostream& os) {
+
+    // Dentro de un lote el ranking solo se reordena cuando algun comando lo necesita
+    if (com.necesita_ranking()) poner_al_dia_ranking();
+
+    if (com.codigo == Comando::NUEVO_JUGADOR) {
+
+        const string& id_p = com.id;
+        os << '#' << com.nombre << ' ' << id_p << endl;
+
+        // Si el jugador con identificador id_p no existe,
+        // añadimos al conjunto de jugadores un jugador
+        // con identificador id_p
+        if (not jugadores.existe_jugador(id_p)) {
+            jugadores.nuevo_jugador(id_p);
+            os << jugadores.numero_jugadores() << endl;
+        } else
+            os << "error: ya existe un jugador con ese nombre" << endl;
+    }
+
+    else if (com.codigo == Comando::NUEVO_TORNEO) {
+
+        const string& id_to = com.id;
+        int ca = com.num;
+        os << '#' << com.nombre << ' ' << id_to << ' ' << ca << endl;
+
+        // Si la categoria "ca" esta entre 1 y c, y no existe el torneo
+        // en el conjunto de torneos, se añade un nuevo torneo con
+        // el identificador id_to y de categoria ca
+        if (ca < 1 or ca > c)
+            os << "error: la categoria no existe" << endl;
+        else if (torneos.existe_torneo(id_to))
+            os << "error: ya existe un torneo con ese nombre" << endl;
+        else {
+            torneos.nuevo_torneo(id_to, map_cat[ca]);
+            os << torneos.numero_torneos() << endl;
+        }
+    }
+
+    else if (com.codigo == Comando::FORMATO_CATEGORIA) {
+
+        int ca = com.num;
+        os << '#' << com.nombre << ' ' << ca << ' ' << com.id << endl;
+
+        // El formato pasa a la categoria, para los torneos que se creen despues,
+        // y a los torneos que ya tiene, para sus proximas ediciones
+        Categoria::Formato f;
+        if (ca < 1 or ca > c)
+            os << "error: la categoria no existe" << endl;
+        else if (not Categoria::leer_formato(com.id, f))
+            os << "error: formato desconocido" << endl;
+        else {
+            map_cat[ca].definir_formato(f);
+            torneos.definir_formato(ca, f);
+        }
+    }
+
+    else if (com.codigo == Comando::BAJA_JUGADOR) {
+
+        const string& id_p = com.id;
+        os << '#' << com.nombre << ' ' << id_p << endl;
+
+        // Si existe un jugador con identificador id_p,
+        // se da de baja del conjunto de jugadores del
+        // circuito al jugador con identificador id_p
+        if (jugadores.existe_jugador(id_p)) {
+            jugadores.baja_jugador(id_p);
+            os << jugadores.numero_jugadores() << endl;
+        } else
+            os << "error: el jugador no existe" << endl;
+    }
+
+    else if (com.codigo == Comando::BAJA_TORNEO) {
+
+        const string& id_to = com.id;
+        os << '#' << com.nombre << ' ' << id_to << endl;
+
+        // Si existe un torneo con identificador id_to,
+        // se da de baja al torneo con el mismo identificador
+        if (torneos.existe_torneo(id_to)) {
+            const Torneo& torn = torneos.consultar_torneo(id_to);
+            torn.restar_puntos(jugadores);
+            ranking_cambiado(id_to, false);
+            torneos.baja_torneo(id_to);
+            os << torneos.numero_torneos() << endl;
+        } else
+            os << "error: el torneo no existe" << endl;
+    }
+
+    else if (com.codigo == Comando::INICIAR_TORNEO) {
+
+        TRAZA_TRAMO("iniciar_torneo");
+        const string& id_to = com.id;
+
+        // Si existe un torneo con identificador id_to
+        // se inicia el torneo con el mismo identificador
+        if (torneos.existe_torneo(id_to)) {
+
+            const Torneo& torn = torneos.consultar_torneo(id_to);
+
+            // 'n' representa el num. de participantes y "com.posiciones" sus
+            // posiciones en el ranking. Los participantes se almacenan en el vector 'r'
+            int n = com.posiciones.size();
+            vector<Jugador> r(n);
+            torn.leer_participantes(r, com.posiciones, jugadores);
+
+            os << '#' << com.nombre << ' ' << id_to << endl;
+
+            // Se calcula 'h', la altura del arbol de emparejamientos
+            int h = ceil(log2(n))+1;
+
+            // Se calcula 'j' que representa los jugadores (nodos) del nivel h-1 que no tendrán hijos
+            // en el arbol en caso de que el ultimo nivel no este completo
+            int j = pow(2, h-1) - n;
+
+            // Construimos el cuadro de emparejamientos en preorden a partir de la raíz 1 (ganador):
+            // "pre" tiene el valor de cada nodo y "der" la posicion de su hijo derecho
+            vector<int> pre, der;
+            {
+                TRAZA_TRAMO("definir_emparejamientos");
+                torn.definir_emparejamientos(pre, der, h, 1, 1, j);
+            }
+
+            // Se imprime el cuadro de emparejamientos
+            torn.imprimir_emparejamientos(pre, der, r, os);
+            os << endl;
+
+            // Asigna el cuadro de emparejamientos y el vector de participantes
+            // en el torneo contenido en el conjunto de torneos
+            // para poder usar dichos atributos en "finalizar_torneo"
+            torneos.definir_cuadro_y_participantes(id_to, move(pre), move(der), move(r));
+        }
+    }
+
+    else if (com.codigo == Comando::FINALIZAR_TORNEO) {
+
+        TRAZA_TRAMO("finalizar_torneo");
+        const string& id_to = com.id;
+
+        // Si existe un torneo con identificador id_to se finaliza este torneo
+        if (torneos.existe_torneo(id_to)) {
+
+            // Se trabaja sobre una copia del torneo, porque al actualizar las estadisticas
+            // se suman los puntos a sus participantes y puede que haya que deshacerlo
+            Torneo torn = torneos.consultar_torneo(id_to);
+
+            // "der" representa la forma del arbol de resultados leidos, que estan
+            // en preorden (y ya convertidos a sets) dentro del lote
+            vector<int> der;
+            torn.leer_resultados(com.resultados, der);
+
+            os << '#' << com.nombre << ' ' << id_to << endl;
+
+            if (not torn.esta_iniciado())
+                os << "error: el torneo no esta iniciado" << endl;
+            else if (not torn.resultados_validos(com.resultados, der))
+                os << "error: el arbol de resultados no es correcto" << endl;
+            else {
+
+                // Se construye 'a', el jugador que llega a cada nodo del cuadro de
+                // resultados del torneo una vez disputados los partidos
+                vector<int> a;
+                torn.proc_resultados(a, com.resultados, der);
+
+                // Se restan los puntos de la edición anterior y se actualizan las estadísticas
+                // de cada jugador dentro de una transaccion: si algun participante se ha dado
+                // de baja, se deshace lo que ya se haya aplicado y el torneo sigue sin finalizar
+                jugadores.iniciar_transaccion();
+                torn.restar_puntos(jugadores);
+                if (not torn.actualizar_estadisticas(a, com.resultados, der, jugadores)) {
+                    jugadores.deshacer_transaccion();
+                    os << "error: algun participante ya no esta en el circuito" << endl;
+                }
+                else {
+                    jugadores.confirmar_transaccion();
+                    partidos.registrar(id_to, torn.consultar_participantes(), a, der, com.resultados);
+                    if (not archivo.archivar(id_to, torn.consultar_participantes(), a, der, com.resultados))
+                        cerr << "error: no se puede archivar el cuadro de " << id_to << endl;
+
+                    // Se imprimen los resultados del torneo
+                    torn.imprimir_resultados(a, com.resultados, der, os);
+                    os << endl;
+
+                    // Se listan los puntos que ha ganado cada jugador y se asignan los participantes del torneo,
+                    // y este se añade al conjunto de torneos
+                    torn.listar_puntos(os);
+                    torneos.definir_ult_jugadores(id_to, torn);
+
+                    // Si los puntos caducan, se programa la caducidad de los que ha conseguido cada participante
+                    if (ventana > 0) {
+                        int ed = torneos.consultar_edicion(id_to);
+                        const vector<Jugador>& part = torn.consultar_participantes();
+                        for (int i = 0; i < (int)part.size(); ++i) {
+                            if (part[i].consultar_ptos_rest() > 0) {
+                                Caducidad cad = {semana + ventana, ed, id_to, i+1};
+                                caducidades.push(cad);
+                            }
+                        }
+                    }
+
+                    ranking_cambiado(id_to, true);
+                }
+            }
+        }
+    }
+
+    else if (com.codigo == Comando::SIMULAR_TORNEO) {
+
+        const string& id_to = com.id;
+        os << '#' << com.nombre << ' ' << id_to << endl;
+
+        // Se aplican los resultados sobre un ranking provisional, sin modificar
+        // a los jugadores, y se escriben los cambios de puntos y posiciones
+        if (not torneos.existe_torneo(id_to))
+            os << "error: el torneo no existe" << endl;
+        else {
+            const Torneo& torn = torneos.consultar_torneo(id_to);
+            vector<int> der;
+            torn.leer_resultados(com.resultados, der);
+            if (not torn.esta_iniciado())
+                os << "error: el torneo no esta iniciado" << endl;
+            else if (not torn.resultados_validos(com.resultados, der))
+                os << "error: el arbol de resultados no es correcto" << endl;
+            else {
+                vector<int> a;
+                torn.proc_resultados(a, com.resultados, der);
+                vector<int> premio;
+                torn.calcular_premios(a, der, premio);
+
+                RankingProvisional prov(jugadores);
+                const vector<Jugador>& ult = torn.consultar_ult_edicion();
+                for (int i = 0; i < (int)ult.size(); ++i)
+                    prov.restar(ult[i].consultar_nombre(), ult[i].consultar_ptos_rest());
+                const vector<Jugador>& part = torn.consultar_participantes();
+                for (int i = 0; i < (int)part.size(); ++i)
+                    prov.sumar(part[i].consultar_nombre(), premio[i]);
+                prov.escribir_cambios(os);
+            }
+        }
+    }
+
+    else if (com.codigo == Comando::DEFINIR_CADUCIDAD) {
+
+        int n = com.num;
+        os << '#' << com.nombre << ' ' << n << endl;
+
+        // La nueva duracion solo se aplica a los puntos de los torneos que se finalicen despues
+        if (n < 0)
+            os << "error: numero de semanas incorrecto" << endl;
+        else
+            ventana = n;
+    }
+
+    else if (com.codigo == Comando::AVANZAR_SEMANAS) {
+
+        int n = com.num;
+        os << '#' << com.nombre << ' ' << n << endl;
+
+        // Se avanza el reloj y se recogen los puntos que caducan hasta la nueva semana,
+        // que son los de la cima del monticulo; se restan todos de una vez y despues se
+        // recoloca a los que han bajado
+        if (n < 0)
+            os << "error: numero de semanas incorrecto" << endl;
+        else {
+            semana += n;
+            os << semana << endl;
+            vector<string> rebajados;
+            vector<int> pts, cats;
+            while (not caducidades.empty() and caducidades.top().semana <= semana) {
+                Caducidad cad = caducidades.top();
+                caducidades.pop();
+                string id_p;
+                int pt, ca;
+                if (torneos.caducar_puntos(cad.torneo, cad.edicion, cad.participante, id_p, pt, ca)
+                    and pt > 0 and jugadores.existe_jugador(id_p)) {
+                    rebajados.push_back(id_p);
+                    pts.push_back(pt);
+                    cats.push_back(ca);
+                    os << cad.torneo << ' ' << id_p << ' ' << pt << endl;
+                }
+            }
+            jugadores.restar_varios(rebajados, pts, cats, hilos);
+            jugadores.actualizar_ranking(rebajados);
+        }
+    }
+
+    else if (com.codigo == Comando::REINICIAR_TEMPORADA) {
+
+        // Se anulan los puntos de todos los jugadores y los que quedaban por restar de las
+        // ultimas ediciones de los torneos, que ya no se restaran de la nueva temporada
+        os << '#' << com.nombre << endl;
+        jugadores.reiniciar_puntos(hilos);
+        torneos.anular_puntos();
+    }
+
+    else if (com.codigo == Comando::INICIO_LOTE) {
+
+        // Hasta el fin del lote, los torneos que se finalicen o se den de baja ya no
+        // reordenan el ranking cada uno: se hace una sola vez cuando se necesita
+        os << '#' << com.nombre << endl;
+        if (lote_abierto)
+            os << "error: ya hay un lote abierto" << endl;
+        else {
+            lote_abierto = true;
+            jugadores.iniciar_aplazamiento();
+        }
+    }
+
+    else if (com.codigo == Comando::FIN_LOTE) {
+
+        // El ranking ya se ha puesto al dia antes de ejecutar el comando
+        os << '#' << com.nombre << endl;
+        if (not lote_abierto)
+            os << "error: no hay ningun lote abierto" << endl;
+        else {
+            lote_abierto = false;
+            jugadores.acabar_aplazamiento();
+        }
+    }
+
+    else if (com.codigo == Comando::CARA_A_CARA) {
+
+        // Se escribe el balance y los partidos entre los dos jugadores, que pueden
+        // haberse dado de baja despues de jugarlos
+        os << '#' << com.nombre << ' ' << com.id << ' ' << com.id2 << endl;
+        partidos.escribir_cara_a_cara(com.id, com.id2, os);
+    }
+
+    else if (com.codigo == Comando::CARGAR_JUGADORES) {
+
+        string fichero = com.id;
+        os << '#' << com.nombre << ' ' << fichero << endl;
+
+        // Se añaden los jugadores del fichero que todavia no existen y se informa
+        // del tiempo de carga por el canal de error para no alterar la salida
+        chrono::steady_clock::time_point ini = chrono::steady_clock::now();
+        if (jugadores.cargar_jugadores(fichero)) {
+            chrono::duration<double, milli> t = chrono::steady_clock::now() - ini;
+            os << jugadores.numero_jugadores() << endl;
+            cerr << "carga de " << fichero << ": " << t.count() << " ms" << endl;
+        } else
+            os << "error: no se puede abrir el fichero" << endl;
+    }
+
+    else if (com.codigo == Comando::CARGAR_TORNEOS) {
+
+        string fichero = com.id;
+        os << '#' << com.nombre << ' ' << fichero << endl;
+
+        // Se añaden los torneos del fichero con categoria valida que todavia no existen
+        chrono::steady_clock::time_point ini = chrono::steady_clock::now();
+        ConjuntoTorneos::Carga c = torneos.cargar_torneos(fichero, map_cat);
+        if (c == ConjuntoTorneos::CARGADO) {
+            chrono::duration<double, milli> t = chrono::steady_clock::now() - ini;
+            os << torneos.numero_torneos() << endl;
+            cerr << "carga de " << fichero << ": " << t.count() << " ms" << endl;
+        }
+        else if (c == ConjuntoTorneos::MAL_FORMADO)
+            os << "error: el fichero tiene un torneo sin categoria" << endl;
+        else
+            os << "error: no se puede abrir el fichero" << endl;
+    }
+
+    else if (com.codigo == Comando::PRONOSTICO_RANKING) {
+
+        int nsim = com.num;
+        os << '#' << com.nombre << ' ' << nsim << ' ' << com.semilla << endl;
+
+        // Se simulan los torneos iniciados que todavia no se han finalizado y se
+        // escribe la posicion media, minima y maxima de cada jugador
+        vector<Torneo> iniciados;
+        torneos.consultar_iniciados(iniciados);
+        if (nsim < 1)
+            os << "error: numero de simulaciones incorrecto" << endl;
+        else if (iniciados.empty())
+            os << "error: no hay torneos iniciados" << endl;
+        else {
+            Pronostico pron(jugadores, iniciados);
+            {
+                TRAZA_TRAMO("pronostico");
+                pron.simular(nsim, com.semilla, hilos);
+            }
+            pron.escribir(os);
+        }
+    }
+
+    else if (com.codigo == Comando::LISTAR_RANKING) {
+
+        os << '#' << com.nombre << endl;
+
+        // Se lista el ranking perteneciente al conjunto de jugadores
+        jugadores.listar_ranking(os);
+    }
+
+    else if (com.codigo == Comando::LISTAR_RANKING_CATEGORIA) {
+
+        int ca = com.num;
+        os << '#' << com.nombre << ' ' << ca << endl;
+
+        // Se lista el ranking con los puntos de los torneos de la categoria "ca"
+        if (ca < 1 or ca > c)
+            os << "error: la categoria no existe" << endl;
+        else
+            jugadores.listar_ranking_categoria(ca, os);
+    }
+
+    else if (com.codigo == Comando::RANKING_ELO) {
+
+        // Se lista el ranking por rating, que no depende del orden del ranking por puntos
+        os << '#' << com.nombre << endl;
+        jugadores.listar_ranking_elo(os);
+    }
+
+    else if (com.codigo == Comando::BUSCAR_JUGADOR) {
+
+        // Se listan los jugadores cuyo nombre empieza por el prefijo
+        os << '#' << com.nombre << ' ' << com.id << endl;
+        jugadores.buscar_jugadores(com.id, os);
+    }
+
+    else if (com.codigo == Comando::LISTAR_JUGADORES) {
+
+        os << '#' << com.nombre << endl;
+
+        // Se listan los jugadores del conjunto de jugadores
+        jugadores.listar_jugadores(os);
+    }
+
+    else if (com.codigo == Comando::CONSULTAR_JUGADOR) {
+
+        const string& id_p = com.id;
+        os << '#' << com.nombre << ' ' << id_p << endl;
+
+        // Si existe un jugador con identificador id_p
+        // se lista a este jugador
+        if (jugadores.existe_jugador(id_p)) {
+            jugadores.consultar_jugador(id_p).listar_jugador(os);
+        } else
+            os << "error: el jugador no existe" << endl;
+    }
+
+    else if (com.codigo == Comando::CONTAR_PUNTOS) {
+
+        os << '#' << com.nombre << ' ' << com.num << endl;
+        os << jugadores.contar_con_puntos(com.num) << endl;
+    }
+
+    else if (com.codigo == Comando::PERCENTIL_JUGADOR) {
+
+        const string& id_p = com.id;
+        os << '#' << com.nombre << ' ' << id_p << endl;
+
+        // El percentil es el porcentaje de jugadores del circuito con menos puntos que el
+        if (jugadores.existe_jugador(id_p)) {
+            int ptos = jugadores.consultar_jugador(id_p).consultar_puntos();
+            ios::fmtflags flags = os.flags();
+            streamsize prec = os.precision();
+            os << fixed << setprecision(2)
+               << 100.0*jugadores.contar_con_menos_puntos(ptos)/jugadores.numero_jugadores() << endl;
+            os.flags(flags);
+            os.precision(prec);
+        } else
+            os << "error: el jugador no existe" << endl;
+    }
+
+    else if (com.codigo == Comando::HISTORIAL_JUGADOR) {
+
+        const string& id_p = com.id;
+        os << '#' << com.nombre << ' ' << id_p << endl;
+
+        // La trayectoria se conserva aunque el jugador se haya dado de baja
+        if (historial.tiene_historial(id_p))
+            historial.escribir_trayectoria(id_p, os);
+        else if (not jugadores.existe_jugador(id_p))
+            os << "error: el jugador no existe" << endl;
+    }
+
+    else if (com.codigo == Comando::CUADRO_ARCHIVADO) {
+
+        const string& id_to = com.id;
+        int ed = com.num;
+        os << '#' << com.nombre << ' ' << id_to << ' ' << ed << endl;
+
+        // Las ediciones archivadas se conservan aunque el torneo se haya dado de baja
+        int n = archivo.numero_ediciones(id_to);
+        if (n == 0 and not torneos.existe_torneo(id_to))
+            os << "error: el torneo no existe" << endl;
+        else if (ed < 1 or ed > n)
+            os << "error: la edicion no existe" << endl;
+        else {
+            archivo.escribir_cuadro(id_to, ed, os);
+            os << endl;
+        }
+    }
+
+    else if (com.codigo == Comando::PUNTOS_CORTE) {
+
+        int pos = com.num;
+        os << '#' << com.nombre << ' ' << pos << endl;
+
+        if (pos < 1 or pos > jugadores.numero_jugadores())
+            os << "error: la posicion no existe" << endl;
+        else
+            os << jugadores.puntos_corte(pos) << endl;
+    }
+
+    else if (com.codigo == Comando::LISTAR_TORNEOS) {
+
+        // Se listan los torneos del conjunto de torneos
+        os << '#' << com.nombre << endl;
+        torneos.listar_torneos(os);
+    }
+
+    else if (com.codigo == Comando::LISTAR_CATEGORIAS) {
+
+        os << '#' << com.nombre << endl;
+        os << c << ' ' << k << endl;
+
+        // Listamos las categorias del map inicializado al principio
+        map<int, Categoria>::iterator it;
+        for (it = map_cat.begin(); it != map_cat.end(); ++it)
+            it->second.listar_categoria(k, os);
+    }
+}
+
+bool Circuito::abrir_archivo(const string& ruta) {
+    return archivo.abrir(ruta);
+}
+
+bool Circuito::hay_lote_abierto() const{
+    return lote_abierto;
+}
+
+const ConjuntoJugadores& Circuito::consultar_jugadores() const{
+    return jugadores;
+}
+
+const ConjuntoTorneos& Circuito::consultar_torneos() const{
+    return torneos;
+}
+
+void Circuito::leer() {
+
+    // Se lee el numero de categorias y el numero maximo de niveles de los torneos
+    cin >> c >> k;
+
+    // Leemos el nombre de cada una y asignamos el indentificador
+    // string y el identificador entero en cada categoria
+    string id_cat;
+    for (int i = 1; i <= c; ++i) {
+        cin >> id_cat;
+        Categoria cat(id_cat,i);
+        map_cat.insert(make_pair(i, cat));
+    }
+
+    // Leemos los puntos pertenecientes a cada nivel de la categoria
+    // a partir del num. maximo de niveles k
+    map<int, Categoria>::iterator it;
+    for (it = map_cat.begin(); it != map_cat.end(); ++it)
+        it->second.asignar_puntos(k);
+
+    // Leemos un conjunto de t torneos
+    int t;
+    cin >> t;
+    torneos = ConjuntoTorneos(t);
+    torneos.leer_torneos(map_cat);
+
+    // Leemos un conjunto de p jugadores
+    int p;
+    cin >> p;
+    jugadores = ConjuntoJugadores(p);
+    jugadores.leer_jugadores();
+}
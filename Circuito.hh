@@ -0,0 +1,147 @@
+/** @file Circuito.hh
+    @brief Especificación de la clase Circuito */
+
+#ifndef CIRCUITO_HH
+#define CIRCUITO_HH
+
+#include "ConjuntoJugadores.hh"
+#include "ConjuntoTorneos.hh"
+#include "Comando.hh"
+#include "ReservaHilos.hh"
+#include "Caducidad.hh"
+#include "RegistroPartidos.hh"
+#include "HistorialRanking.hh"
+#include "ArchivoCuadros.hh"
+
+#ifndef NO_DIAGRAM
+#include <queue>
+#endif
+
+/** @class Circuito
+    @brief Representa el circuito de torneos completo.
+    Contiene las categorías con su tabla de puntos por nivel, el conjunto de
+    torneos y el conjunto de jugadores, y aplica sobre ellos los comandos.
+*/
+class Circuito {
+
+private:
+
+    /** @brief Número de categorías */
+    int c;
+
+    /** @brief Número máximo de niveles de los torneos */
+    int k;
+
+    /** @brief map de <em>Categoria</em> con su identificador entero como clave */
+    map<int, Categoria> map_cat;
+
+    ConjuntoTorneos torneos;
+    ConjuntoJugadores jugadores;
+
+    /** @brief Hilos de trabajo para los comandos que se calculan en paralelo */
+    ReservaHilos hilos;
+
+    /** @brief Semana actual del reloj lógico del circuito */
+    int semana;
+
+    /** @brief Semanas que duran los puntos de un torneo, o 0 si solo se restan al
+        volver a finalizar el torneo */
+    int ventana;
+
+    /** @brief Caducidades pendientes, con la más próxima en la cima */
+    priority_queue<Caducidad, vector<Caducidad>, greater<Caducidad> > caducidades;
+
+    /** @brief Historial de los partidos de todos los torneos finalizados */
+    RegistroPartidos partidos;
+
+    /** @brief Evolución del ranking tras cada torneo finalizado o dado de baja */
+    HistorialRanking historial;
+
+    /** @brief Cuadros de resultados de todas las ediciones finalizadas */
+    ArchivoCuadros archivo;
+
+    /** @brief Indica si hay un lote abierto con <em>inicio_lote</em> */
+    bool lote_abierto;
+
+    /** @brief Indica si han cambiado los puntos dentro del lote y todavía no se ha
+        reordenado el ranking, y el último torneo finalizado ("final" cierto) o dado de
+        baja que los ha cambiado */
+    bool ranking_pendiente;
+    string torneo_pendiente;
+    bool final_pendiente;
+
+    /** @brief Función privada que se llama cuando un torneo ha cambiado los puntos
+        \pre Se acaba de finalizar ("final" cierto) o de dar de baja el torneo "id_to"
+        \post Si no hay ningún lote abierto, se ha reordenado el ranking y se ha registrado
+        en el historial; si lo hay, se ha aplazado hasta que un comando lo necesite
+    */
+    void ranking_cambiado(const string& id_to, bool final);
+
+    /** @brief Función privada que pone al día el ranking
+        \pre <em>Cierto</em>
+        \post Si había cambios pendientes en el lote, se ha reordenado el ranking y se ha
+        registrado un solo evento en el historial, con el último torneo que los cambió
+    */
+    void poner_al_dia_ranking();
+
+public:
+
+    // Constructor
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un circuito vacío
+    */
+    Circuito();
+
+
+    // Modificador
+
+    /** @brief Aplica un comando al circuito
+        \pre "com" es un comando leído por un <em>LectorComandos</em>
+        \post Se ha aplicado el comando al circuito y se ha escrito su salida a través del canal "os"
+    */
+    void ejecutar(const Comando& com, ostream& os);
+
+    /** @brief Se guarda el archivo de cuadros en un fichero
+        \pre No se ha finalizado ningún torneo
+        \post Los cuadros de las ediciones que se finalicen se añaden al archivo del fichero
+        "ruta", que se ha creado si no existía; las que ya tenía se pueden consultar. El
+        resultado indica si se ha podido abrir
+    */
+    bool abrir_archivo(const string& ruta);
+
+
+    // Consultores
+
+    /** @brief Consulta si hay un lote abierto
+        \pre <em>Cierto</em>
+        \post El resultado indica si se ha abierto un lote con <em>inicio_lote</em> que
+        todavía no se ha cerrado; mientras, el orden del ranking puede no estar al día
+    */
+    bool hay_lote_abierto() const;
+
+    /** @brief Consultor del conjunto de jugadores
+        \pre <em>Cierto</em>
+        \post El resultado es el conjunto de jugadores del circuito
+    */
+    const ConjuntoJugadores& consultar_jugadores() const;
+
+    /** @brief Consultor del conjunto de torneos
+        \pre <em>Cierto</em>
+        \post El resultado es el conjunto de torneos del circuito
+    */
+    const ConjuntoTorneos& consultar_torneos() const;
+
+
+    // Lectura
+
+    /** @brief Operación de lectura de los datos iniciales del circuito
+        \pre Hay preparados en el canal estándar de entrada el número de categorías, el número
+        máximo de niveles, los nombres de las categorías, sus tablas de puntos, los torneos y
+        los jugadores iniciales
+        \post El circuito contiene las categorías, los torneos y los jugadores leídos
+    */
+    void leer();
+};
+#endif
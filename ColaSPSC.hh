@@ -0,0 +1,75 @@
+#ifndef COLASPSC_HH
+#define COLASPSC_HH
+
+#include <atomic>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// A ColaSPSC<T> is a bounded lock-free queue for exactly one producer thread
+// and one consumer thread. Elements are moved in and out of a ring buffer whose
+// capacity is rounded up to a power of two.
+template <typename T> class ColaSPSC {
+
+    vector<T> buf;
+    size_t mascara;
+
+    // Each index is written by one side only; they live on separate cache lines
+    // so that the producer and the consumer do not keep invalidating each other.
+    alignas(64) atomic<size_t> cabeza;   // next slot to read (consumer)
+    alignas(64) atomic<size_t> cola;     // next slot to write (producer)
+    alignas(64) atomic<bool> cerrada;
+
+public:
+
+    // Constructs an empty open queue with room for at least n elements.
+    ColaSPSC (size_t n)
+    :   cabeza(0), cola(0), cerrada(false)
+    {
+        size_t cap = 1;
+        while (cap < n) cap *= 2;
+        buf.resize(cap);
+        mascara = cap - 1;
+    }
+
+    // Moves x into the queue if there is room. Producer only.
+    bool intentar_encolar (T& x) {
+        size_t c = cola.load(memory_order_relaxed);
+        if (c - cabeza.load(memory_order_acquire) > mascara) return false;
+        buf[c & mascara] = move(x);
+        cola.store(c + 1, memory_order_release);
+        return true;
+    }
+
+    // Moves the oldest element into x if there is any. Consumer only.
+    bool intentar_desencolar (T& x) {
+        size_t h = cabeza.load(memory_order_relaxed);
+        if (h == cola.load(memory_order_acquire)) return false;
+        x = move(buf[h & mascara]);
+        cabeza.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // Moves x into the queue, waiting while it is full. Producer only.
+    void encolar (T& x) {
+        while (not intentar_encolar(x)) this_thread::yield();
+    }
+
+    // Moves the oldest element into x, waiting while the queue is empty.
+    // Returns false once the queue is closed and every element has been read.
+    // Consumer only.
+    bool desencolar (T& x) {
+        while (not intentar_desencolar(x)) {
+            if (cerrada.load(memory_order_acquire)) return intentar_desencolar(x);
+            this_thread::yield();
+        }
+        return true;
+    }
+
+    // Tells the consumer that no more elements will be added. Producer only.
+    void cerrar () {
+        cerrada.store(true, memory_order_release);
+    }
+};
+
+#endif
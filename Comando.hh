@@ -0,0 +1,112 @@
+/** @file Comando.hh
+    @brief Especificación del registro Comando */
+
+#ifndef COMANDO_HH
+#define COMANDO_HH
+
+#include "LoteResultados.hh"
+
+#ifndef NO_DIAGRAM
+#include <string>
+#include <vector>
+#endif
+using namespace std;
+
+/** @struct Comando
+    @brief Representa un comando ya leído y separado en sus datos.
+    Contiene el código del comando, el nombre con el que se ha escrito en la
+    entrada (completo o abreviado, que es el que se repite en la salida) y los
+    datos que lo acompañan según el comando.
+*/
+struct Comando {
+
+    /** @brief Códigos de los comandos reconocidos */
+    enum Codigo {
+        DESCONOCIDO,
+        NUEVO_JUGADOR,
+        NUEVO_TORNEO,
+        BAJA_JUGADOR,
+        BAJA_TORNEO,
+        INICIAR_TORNEO,
+        FINALIZAR_TORNEO,
+        LISTAR_RANKING,
+        LISTAR_JUGADORES,
+        CONSULTAR_JUGADOR,
+        LISTAR_TORNEOS,
+        LISTAR_CATEGORIAS,
+        CARGAR_JUGADORES,
+        CARGAR_TORNEOS,
+        PRONOSTICO_RANKING,
+        SIMULAR_TORNEO,
+        DEFINIR_CADUCIDAD,
+        AVANZAR_SEMANAS,
+        CARA_A_CARA,
+        LISTAR_RANKING_CATEGORIA,
+        CONTAR_PUNTOS,
+        PERCENTIL_JUGADOR,
+        PUNTOS_CORTE,
+        REINICIAR_TEMPORADA,
+        HISTORIAL_JUGADOR,
+        INICIO_LOTE,
+        FIN_LOTE,
+        FORMATO_CATEGORIA,
+        CUADRO_ARCHIVADO,
+        RANKING_ELO,
+        BUSCAR_JUGADOR
+    };
+
+    Codigo codigo;
+
+    /** @brief Nombre del comando tal y como aparece en la entrada */
+    string nombre;
+
+    /** @brief Identificador del jugador, del torneo, nombre de fichero, formato de <em>formato_categoria</em>
+        o prefijo de <em>buscar_jugador</em> */
+    string id;
+
+    /** @brief Identificador del segundo jugador de <em>cara_a_cara</em> */
+    string id2;
+
+    /** @brief Categoria de <em>nuevo_torneo</em>, <em>listar_ranking_categoria</em> o <em>formato_categoria</em>, edición de <em>cuadro_archivado</em>, número de simulaciones de <em>pronostico_ranking</em>,
+        número de semanas de <em>definir_caducidad</em> y <em>avanzar_semanas</em>, puntos de <em>contar_puntos</em>
+        o posición de <em>puntos_corte</em> */
+    int num;
+
+    /** @brief Semilla de <em>pronostico_ranking</em> */
+    int semilla;
+
+    /** @brief Número de secuencia (o marca de tiempo) con el que llega el comando de una
+        entrada secuenciada (ver <em>LectorFuentes</em>); 0 en las demás */
+    long long secuencia;
+
+    /** @brief Posiciones en el ranking de los participantes de <em>iniciar_torneo</em> */
+    vector<int> posiciones;
+
+    /** @brief Resultados de <em>finalizar_torneo</em> o <em>simular_torneo</em> en preorden, ya convertidos a sets */
+    LoteResultados resultados;
+
+    /** @brief Operación de consulta
+        \pre <em>Cierto</em>
+        \post El resultado indica si el comando puede modificar los jugadores o los torneos
+    */
+    bool modifica() const {
+        return codigo == NUEVO_JUGADOR or codigo == NUEVO_TORNEO or codigo == BAJA_JUGADOR
+            or codigo == BAJA_TORNEO or codigo == INICIAR_TORNEO or codigo == FINALIZAR_TORNEO
+            or codigo == CARGAR_JUGADORES or codigo == CARGAR_TORNEOS or codigo == AVANZAR_SEMANAS
+            or codigo == REINICIAR_TEMPORADA or codigo == FIN_LOTE or codigo == FORMATO_CATEGORIA;
+    }
+
+    /** @brief Operación de consulta
+        \pre <em>Cierto</em>
+        \post El resultado indica si el comando necesita que el orden del ranking y las
+        posiciones de los jugadores estén al día, y no solo sus puntos
+    */
+    bool necesita_ranking() const {
+        return codigo == BAJA_JUGADOR or codigo == INICIAR_TORNEO or codigo == LISTAR_RANKING
+            or codigo == LISTAR_JUGADORES or codigo == CONSULTAR_JUGADOR or codigo == CARGAR_JUGADORES
+            or codigo == PRONOSTICO_RANKING or codigo == SIMULAR_TORNEO or codigo == AVANZAR_SEMANAS
+            or codigo == REINICIAR_TEMPORADA or codigo == HISTORIAL_JUGADOR or codigo == FIN_LOTE
+            or codigo == BUSCAR_JUGADOR;
+    }
+};
+#endif
@@ -0,0 +1,27 @@
+/** @file Compartido.hh
+    @brief Función para modificar datos compartidos con las instantáneas */
+
+#ifndef COMPARTIDO_HH
+#define COMPARTIDO_HH
+
+#ifndef NO_DIAGRAM
+#include <atomic>
+#include <memory>
+#endif
+using namespace std;
+
+/** @brief Da un dato compartido para modificarlo
+    Los conjuntos comparten sus partes con las instantáneas del servidor de consultas
+    hasta que las modifican. Solo el hilo que modifica el conjunto crea referencias
+    nuevas, así que si tiene la única no la puede dejar de tener; la barrera asegura
+    que las lecturas de los hilos que han soltado las suyas ya han acabado.
+    \pre "p" no es nulo, y solo lo modifica el hilo que llama
+    \post Si "p" se compartía, ahora apunta a una copia propia; el resultado es el dato
+    al que apunta
+*/
+template <typename T> T& propio(shared_ptr<T>& p) {
+    if (p.use_count() > 1) p = make_shared<T>(*p);
+    else atomic_thread_fence(memory_order_acquire);
+    return *p;
+}
+#endif
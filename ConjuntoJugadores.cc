@@ -2,11 +2,25 @@
     @brief Código de la clase ConjuntoJugadores */
 
 #include "ConjuntoJugadores.hh"
+#include "Tokenizador.hh"
+#include "Traza.hh"
 #include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <iomanip>
 using namespace std;
 
 // Funciones privadas
 
+int ConjuntoJugadores::fragmento(string_view id_p) {
+    return hash<string_view>()(id_p) % NUM_FRAGMENTOS;
+}
+
+Jugador& ConjuntoJugadores::jugador(string_view id_p) {
+    return propio(fragmentos[fragmento(id_p)]).find(id_p)->second;
+}
+
 void ConjuntoJugadores::swap(vector<Jugador>& rank, int x, int y) {
     Jugador aux = rank[y];
     rank[y] = rank[x];
@@ -19,117 +33,518 @@ bool ConjuntoJugadores::cmp(Jugador& a, Jugador& b) {
     return a.consultar_posicion() < b.consultar_posicion();
 }
 
+void ConjuntoJugadores::tocar(int i) {
+    if (aplazando) {
+        if ((int)ptos_aplazados.size() <= i) {
+            ptos_aplazados.resize(njug);
+            toque.resize(njug, 0);
+        }
+        if (ptos_aplazados[i].empty()) {
+            ptos_aplazados[i].push_back(make_pair(0, (*rank)[i].consultar_puntos()));
+            tocados.push_back(i);
+        }
+        if (toque[i] != aplazadas + 1) {
+            toque[i] = aplazadas + 1;
+            tocados_ultima.push_back(i);
+        }
+    }
+}
+
+void ConjuntoJugadores::ordenar_por_puntos(vector<int>& orden, bool por_posicion, ReservaHilos* hilos) const{
+    int n = rank->size();
+
+    // Claves compactas: puntos cambiados de signo, para que el orden creciente sea el del
+    // ranking, desempate e indice. El radix sort es estable, asi que si se desempata por el
+    // indice no hace falta ninguna pasada sobre el desempate
+    struct Clave {
+        unsigned int ptos;
+        unsigned int desempate;
+        int ind;
+    };
+    int max_ptos = 0;
+    unsigned int max_desempate = 0;
+    for (int i = 0; i < n; ++i) {
+        max_ptos = max(max_ptos, (*rank)[i].consultar_puntos());
+        if (por_posicion) max_desempate = max(max_desempate, (unsigned int)(*rank)[i].consultar_posicion());
+    }
+    vector<Clave> v(n), aux(n);
+    for (int i = 0; i < n; ++i) {
+        v[i].ptos = max_ptos - (*rank)[i].consultar_puntos();
+        v[i].desempate = por_posicion ? (*rank)[i].consultar_posicion() : 0;
+        v[i].ind = i;
+    }
+
+    // Los bloques se reparten entre los hilos; cada uno cuenta sus digitos y despues
+    // coloca sus claves a partir de lo que dejan los bloques anteriores con el mismo digito
+    const int DIGITOS = 256;
+    int nbloques = 1;
+    if (hilos != NULL) nbloques = max(1, min(4*hilos->numero_hilos(), n/(1 << 16)));
+    auto ejecutar = [hilos, nbloques](const function<void(int, int)>& f) {
+        if (nbloques == 1) f(0, 0);
+        else hilos->ejecutar(nbloques, f);
+    };
+    vector< vector<int> > cuenta(nbloques, vector<int>(DIGITOS));
+    auto pasada = [&](bool sobre_ptos, int despl) {
+        ejecutar([&](int b, int) {
+            vector<int>& c = cuenta[b];
+            fill(c.begin(), c.end(), 0);
+            for (int i = (long long)n*b/nbloques; i < (long long)n*(b+1)/nbloques; ++i)
+                ++c[((sobre_ptos ? v[i].ptos : v[i].desempate) >> despl) & (DIGITOS-1)];
+        });
+        int acum = 0;
+        for (int d = 0; d < DIGITOS; ++d) {
+            for (int b = 0; b < nbloques; ++b) {
+                int x = cuenta[b][d];
+                cuenta[b][d] = acum;
+                acum += x;
+            }
+        }
+        ejecutar([&](int b, int) {
+            vector<int>& c = cuenta[b];
+            for (int i = (long long)n*b/nbloques; i < (long long)n*(b+1)/nbloques; ++i)
+                aux[c[((sobre_ptos ? v[i].ptos : v[i].desempate) >> despl) & (DIGITOS-1)]++] = v[i];
+        });
+        v.swap(aux);
+    };
+
+    // Primero el desempate y despues los puntos, un byte cada vez y solo los que hacen falta
+    for (int despl = 0; despl < 32 and (max_desempate >> despl) > 0; despl += 8) pasada(false, despl);
+    for (int despl = 0; despl < 32 and ((unsigned int)max_ptos >> despl) > 0; despl += 8) pasada(true, despl);
+
+    orden.resize(n);
+    for (int i = 0; i < n; ++i) orden[i] = v[i].ind;
+}
+
+void ConjuntoJugadores::aplicar_orden(const vector<int>& orden, ReservaHilos* hilos) {
+    int n = orden.size();
+    vector<int> nueva_pos(n);
+    for (int i = 0; i < n; ++i) nueva_pos[orden[i]] = i+1;
+
+    // Los jugadores se mueven a su casilla nueva y cada fragmento corrige las posiciones
+    // de los suyos a partir de su casilla antigua, sin buscarlos por nombre
+    vector<Jugador>& viejo = propio(rank);
+    vector<Jugador> nuevo(n);
+    auto mover = [&viejo, &orden, &nuevo, n](int b, int nb) {
+        for (int i = (long long)n*b/nb; i < (long long)n*(b+1)/nb; ++i) {
+            nuevo[i] = move(viejo[orden[i]]);
+            nuevo[i].modificar_posicion(i+1);
+        }
+    };
+    auto corregir = [this, &nueva_pos](int f) {
+        MapaJugadores& frag = propio(fragmentos[f]);
+        MapaJugadores::iterator it;
+        for (it = frag.begin(); it != frag.end(); ++it)
+            it->second.modificar_posicion(nueva_pos[it->second.consultar_posicion() - 1]);
+    };
+    if (hilos == NULL) {
+        mover(0, 1);
+        for (int f = 0; f < NUM_FRAGMENTOS; ++f) corregir(f);
+    }
+    else {
+        int nb = max(1, min(4*hilos->numero_hilos(), n/(1 << 12)));
+        hilos->ejecutar(nb, [&mover, nb](int b, int) { mover(b, nb); });
+        hilos->ejecutar(NUM_FRAGMENTOS, [&corregir](int f, int) { corregir(f); });
+    }
+    viejo.swap(nuevo);
+}
+
+bool ConjuntoJugadores::delante_aplazado(int x, int y) const{
+
+    // Se va hacia atras por las reordenaciones aplazadas, saltando directamente a la
+    // anterior en la que alguno de los dos cambio de puntos, hasta que no empatan
+    static const vector< pair<int, int> > sin_cambios;
+    const vector< pair<int, int> >& hx = x < (int)ptos_aplazados.size() ? ptos_aplazados[x] : sin_cambios;
+    const vector< pair<int, int> >& hy = y < (int)ptos_aplazados.size() ? ptos_aplazados[y] : sin_cambios;
+    int ix = hx.size() - 1, iy = hy.size() - 1;
+    int e = aplazadas;
+    while (e >= 1) {
+        while (ix >= 0 and hx[ix].first > e) --ix;
+        while (iy >= 0 and hy[iy].first > e) --iy;
+        int px = ix >= 0 ? hx[ix].second : (*rank)[x].consultar_puntos();
+        int py = iy >= 0 ? hy[iy].second : (*rank)[y].consultar_puntos();
+        if (px != py) return px > py;
+        e = max(ix >= 0 ? hx[ix].first : 0, iy >= 0 ? hy[iy].first : 0) - 1;
+    }
+
+    // Antes de la primera, el orden lo daba la posicion guardada, como en "cmp"
+    return (*rank)[x].consultar_posicion() < (*rank)[y].consultar_posicion();
+}
+
+void ConjuntoJugadores::cambiar_en_categoria(const string& id_p, int c, int antes, int despues) {
+    if (antes == despues) return;
+    if ((int)rank_cat.size() < c) rank_cat.resize(c);
+    if (antes > 0) rank_cat[c-1].erase(make_pair(-antes, id_p));
+    if (despues > 0) rank_cat[c-1].insert(make_pair(-despues, id_p));
+}
+
+void ConjuntoJugadores::anotar(const string& id_p) {
+    if (transaccion and registro.find(id_p) == registro.end()) {
+        const MapaJugadores& f = *fragmentos[fragmento(id_p)];
+        MapaJugadores::const_iterator it = f.find(id_p);
+        if (it != f.end()) {
+            int i = it->second.consultar_posicion();
+            registro.insert(make_pair(id_p, make_pair(it->second, (*rank)[i-1])));
+        }
+    }
+}
+
 
 // Funciones publicas
 
-ConjuntoJugadores::ConjuntoJugadores() {
+ConjuntoJugadores::ConjuntoJugadores() : fragmentos(NUM_FRAGMENTOS) {
+    for (int f = 0; f < NUM_FRAGMENTOS; ++f) fragmentos[f] = make_shared<MapaJugadores>();
+    rank = make_shared< vector<Jugador> >();
     njug = 0;
+    transaccion = false;
+    aplazando = false;
+    aplazadas = 0;
 }
 
-ConjuntoJugadores::ConjuntoJugadores(int p) {
+ConjuntoJugadores::ConjuntoJugadores(int p) : fragmentos(NUM_FRAGMENTOS) {
+    for (int f = 0; f < NUM_FRAGMENTOS; ++f) fragmentos[f] = make_shared<MapaJugadores>();
+    rank = make_shared< vector<Jugador> >();
     njug = p;
+    transaccion = false;
+    aplazando = false;
+    aplazadas = 0;
 }
 
-void ConjuntoJugadores::nuevo_jugador(string& id_p) {
+void ConjuntoJugadores::nuevo_jugador(string_view id_p) {
     ++njug;
-    Jugador jug(id_p, njug);
-    map_jug.insert(make_pair(id_p, jug));
-    rank.push_back(jug);
+    Jugador jug(string(id_p), njug);
+    propio(rank).push_back(jug);
+    propio(fragmentos[fragmento(id_p)]).emplace(jug.consultar_nombre(), move(jug));
+    dist_ptos.sumar(0, 1);
+
+    // Si ya hay reordenaciones aplazadas, en todas ellas habria quedado detras de los demas
+    if (aplazando and aplazadas > 0) {
+        tocar(njug-1);
+        ptos_aplazados[njug-1][0].second = INT_MIN;
+    }
 }
 
-void ConjuntoJugadores::baja_jugador(string& id_p) {
+void ConjuntoJugadores::baja_jugador(string_view id_p) {
+
+    // Lo quitamos de los rankings de las categorias y de la distribucion de puntos
+    MapaJugadores& f = propio(fragmentos[fragmento(id_p)]);
+    MapaJugadores::iterator it = f.find(id_p);
+    const Jugador& jug = it->second;
+    for (int c = 1; c <= (int)rank_cat.size(); ++c)
+        cambiar_en_categoria(it->first, c, jug.consultar_ptos_cat(c), 0);
+    dist_ptos.sumar(jug.consultar_puntos(), -1);
 
     // Eliminamos al jugador del mapa y disminuimos el numero de jugadores
     --njug;
-    map_jug.erase(id_p);
+    f.erase(it);
     
     // Buscamos el jugador que queremos eliminar en el ranking y lo intercambiamos con 
     // los jugadores posteriores subiendo la posición de estos jugadores hasta dejar 
     // al jugador eliminado ultimo y hacemos pop_back para eliminarlo
-    int n = rank.size();
+    vector<Jugador>& r = propio(rank);
+    int n = r.size();
     int i = 0;
     bool trobat = false;
     while (i < n-1 and not trobat) {
-        if (rank[i].consultar_nombre() == id_p) {
+        if (r[i].consultar_nombre() == id_p) {
             trobat = true;
             for (int j = i; j < n-1; ++j) {
-                swap(rank, j, j+1);
-                string x = rank[j].consultar_nombre();
-                map_jug[x].modificar_posicion(j+1);
+                swap(r, j, j+1);
+                jugador(r[j].consultar_nombre()).modificar_posicion(j+1);
             }
         }
         ++i;
     }
-    rank.pop_back();
+    r.pop_back();
 }
 
 void ConjuntoJugadores::actualizar_ranking() {
+    TRAZA_TRAMO("actualizar_ranking");
+
+    // Ordenamos las casillas decrecientemente por puntos y, en caso de empate, por la
+    // posicion que guarda cada una, como cmp. Si hay reordenaciones aplazadas, se ordenan
+    // con el orden que habrian dado todas ellas
+    vector<int> orden;
+    if (aplazadas == 0) ordenar_por_puntos(orden, true, NULL);
+    else {
+        orden.resize(njug);
+        for (int i = 0; i < njug; ++i) orden[i] = i;
+        sort(orden.begin(), orden.end(), [this](int a, int b) { return delante_aplazado(a, b); });
+        aplazadas = 0;
+    }
+    aplicar_orden(orden, NULL);
+    for (int i = 0; i < (int)tocados.size(); ++i) {
+        ptos_aplazados[tocados[i]].clear();
+        toque[tocados[i]] = 0;
+    }
+    tocados.clear();
+    tocados_ultima.clear();
+}
 
-    // Ordenamos el vector decrecientemente por puntos
-    sort(rank.begin(), rank.end(), cmp);
-    
-    // En el caso de que algun jugador no tenga la posicion que indica el ranking, se modifica
-    string x;
-    for (int i = 0; i < njug; ++i) {
-        x = rank[i].consultar_nombre();
-        map_jug[x].modificar_posicion(i+1);
-        rank[i].modificar_posicion(i+1);
+void ConjuntoJugadores::actualizar_ranking(const vector<string>& rebajados) {
+    TRAZA_TRAMO("actualizar_ranking_rebajados");
+
+    // Posiciones en el ranking de los jugadores que han perdido puntos
+    vector<int> pos;
+    for (int i = 0; i < (int)rebajados.size(); ++i) {
+        const MapaJugadores& f = *fragmentos[fragmento(rebajados[i])];
+        MapaJugadores::const_iterator it = f.find(rebajados[i]);
+        if (it != f.end()) pos.push_back(it->second.consultar_posicion() - 1);
+    }
+    if (pos.empty()) return;
+    sort(pos.begin(), pos.end());
+    pos.erase(unique(pos.begin(), pos.end()), pos.end());
+
+    // Como solo bajan, lo que va por delante del primero no cambia. Del resto, los
+    // rebajados se ordenan aparte y se mezclan con los demas, que ya estan ordenados
+    int ini = pos[0];
+    vector<Jugador>& r = propio(rank);
+    vector<Jugador> bajan, quedan;
+    int k = 0;
+    for (int i = ini; i < njug; ++i) {
+        if (k < (int)pos.size() and pos[k] == i) {
+            bajan.push_back(r[i]);
+            ++k;
+        } else
+            quedan.push_back(r[i]);
+    }
+    sort(bajan.begin(), bajan.end(), cmp);
+    merge(quedan.begin(), quedan.end(), bajan.begin(), bajan.end(), r.begin() + ini, cmp);
+
+    // Solo se toca el map de los jugadores que han cambiado de posicion
+    for (int i = ini; i < njug; ++i) {
+        if (r[i].consultar_posicion() != i+1) {
+            jugador(r[i].consultar_nombre()).modificar_posicion(i+1);
+            r[i].modificar_posicion(i+1);
+        }
     }
 }
 
-void ConjuntoJugadores::sumar_restar_juegos(int a, int b, int x, int y, const vector<Jugador>& part) {
-    string nom = part[a-1].consultar_nombre();
-    map_jug[nom].sumar_juegos(x);
-    map_jug[nom].restar_juegos(y);
+void ConjuntoJugadores::actualizar_ranking(ReservaHilos& hilos) {
+    TRAZA_TRAMO("actualizar_ranking_paralelo");
 
-    nom = part[b-1].consultar_nombre();
-    map_jug[nom].sumar_juegos(y);
-    map_jug[nom].restar_juegos(x);
+    // A igualdad de puntos se usa el sitio que ocupan en "rank"; la posicion que guarda
+    // "rank" puede haberse quedado atrasada tras una baja
+    vector<int> orden;
+    ordenar_por_puntos(orden, false, &hilos);
+    aplicar_orden(orden, &hilos);
 }
 
-void ConjuntoJugadores::sumar_restar_set(int a, int b, const vector<Jugador>& part) {
-    string nom = part[a-1].consultar_nombre();
-    map_jug[nom].sumar_set();
+void ConjuntoJugadores::iniciar_aplazamiento() {
+    aplazando = true;
+    aplazadas = 0;
+}
 
-    nom = part[b-1].consultar_nombre();
-    map_jug[nom].restar_set();
+void ConjuntoJugadores::aplazar_ranking() {
+    ++aplazadas;
+    for (int i = 0; i < (int)tocados_ultima.size(); ++i) {
+        int t = tocados_ultima[i];
+        if (ptos_aplazados[t].back().second != (*rank)[t].consultar_puntos())
+            ptos_aplazados[t].push_back(make_pair(aplazadas, (*rank)[t].consultar_puntos()));
+    }
+    tocados_ultima.clear();
 }
 
-void ConjuntoJugadores::sumar_restar_partido(int a, int b, const vector<Jugador>& part) {
-    string nom = part[a-1].consultar_nombre();
-    map_jug[nom].sumar_partido();
+void ConjuntoJugadores::acabar_aplazamiento() {
+    aplazando = false;
+}
 
-    nom = part[b-1].consultar_nombre();
-    map_jug[nom].restar_partido();
+void ConjuntoJugadores::sumar_restar_juegos(int a, int b, int x, int y, const vector<Jugador>& part) {
+    const string& nom_a = part[a-1].consultar_nombre();
+    anotar(nom_a);
+    Jugador& jug_a = jugador(nom_a);
+    jug_a.sumar_juegos(x);
+    jug_a.restar_juegos(y);
+
+    const string& nom_b = part[b-1].consultar_nombre();
+    anotar(nom_b);
+    Jugador& jug_b = jugador(nom_b);
+    jug_b.sumar_juegos(y);
+    jug_b.restar_juegos(x);
 }
 
-void ConjuntoJugadores::sumar_puntos(Categoria& cat, int nivel, int a, vector<Jugador>& part) {
-    int x = cat.consultar_puntos(nivel);
-    string nom = part[a-1].consultar_nombre();
-    int i = map_jug[nom].consultar_posicion();
+void ConjuntoJugadores::sumar_restar_set(int a, int b, const vector<Jugador>& part) {
+    const string& nom_a = part[a-1].consultar_nombre();
+    anotar(nom_a);
+    jugador(nom_a).sumar_set();
+
+    const string& nom_b = part[b-1].consultar_nombre();
+    anotar(nom_b);
+    jugador(nom_b).restar_set();
+}
+
+void ConjuntoJugadores::sumar_restar_partido(int a, int b, bool jugado, const vector<Jugador>& part) {
+    const string& nom_a = part[a-1].consultar_nombre();
+    anotar(nom_a);
+    Jugador& jug_a = jugador(nom_a);
+    jug_a.sumar_partido();
+
+    const string& nom_b = part[b-1].consultar_nombre();
+    anotar(nom_b);
+    Jugador& jug_b = jugador(nom_b);
+    jug_b.restar_partido();
+
+    // El ganador se lleva la parte de K_ELO que no se esperaba que ganara
+    if (jugado) {
+        double esperado = 1/(1 + pow(10.0, (jug_b.consultar_elo() - jug_a.consultar_elo())/400));
+        double d = K_ELO*(1 - esperado);
+        jug_a.sumar_elo(d);
+        jug_b.sumar_elo(-d);
+    }
+}
 
-    rank[i-1].sum_ptos(x);
-    map_jug[nom].sum_ptos(x);
+void ConjuntoJugadores::sumar_puntos(const Categoria& cat, int nivel, int a, vector<Jugador>& part) {
+    int x = cat.consultar_puntos(nivel);
+    const string& nom = part[a-1].consultar_nombre();
+    anotar(nom);
+    Jugador& jug = jugador(nom);
+    int i = jug.consultar_posicion();
+    tocar(i-1);
+
+    dist_ptos.sumar(jug.consultar_puntos(), -1);
+    vector<Jugador>& r = propio(rank);
+    r[i-1].sum_ptos(x);
+    jug.sum_ptos(x);
+    dist_ptos.sumar(jug.consultar_puntos(), 1);
     part[a-1].sum_ptos(x);
 
+    int c = cat.consultar_id();
+    if (c >= 1) {
+        int antes = jug.consultar_ptos_cat(c);
+        r[i-1].sum_ptos_cat(c, x);
+        jug.sum_ptos_cat(c, x);
+        cambiar_en_categoria(nom, c, antes, jug.consultar_ptos_cat(c));
+    }
 }
 
-void ConjuntoJugadores::restar(string& id_p, int pt) {
+
+void ConjuntoJugadores::restar(string_view id_p, int pt, int c) {
 
     // Si el jugador con identificador "id_p" está dentro del conjunto de jugadores, 
     // se le restan los puntos y se le restan al mismo jugador del ranking
-    map<string, Jugador>::iterator it = map_jug.find(id_p);
-    if (it != map_jug.end()) {
-        map_jug[id_p].rest(pt);
-        int i = map_jug[id_p].consultar_posicion();
-        rank[i-1].rest(pt);
+    MapaJugadores& f = propio(fragmentos[fragmento(id_p)]);
+    MapaJugadores::iterator it = f.find(id_p);
+    if (it != f.end()) {
+        anotar(it->first);
+        int i = it->second.consultar_posicion();
+        tocar(i-1);
+        dist_ptos.sumar(it->second.consultar_puntos(), -1);
+        it->second.rest(pt);
+        dist_ptos.sumar(it->second.consultar_puntos(), 1);
+        vector<Jugador>& r = propio(rank);
+        r[i-1].rest(pt);
+        if (c >= 1) {
+            int antes = it->second.consultar_ptos_cat(c);
+            it->second.rest_cat(c, pt);
+            r[i-1].rest_cat(c, pt);
+            cambiar_en_categoria(it->first, c, antes, it->second.consultar_ptos_cat(c));
+        }
     }
     
 }
 
-bool ConjuntoJugadores::existe_jugador(string& id_p) {
-    map<string, Jugador>::iterator it = map_jug.find(id_p);
-    if (it != map_jug.end()) return true;
+void ConjuntoJugadores::restar_varios(const vector<string>& ids, const vector<int>& pts,
+                                      const vector<int>& cats, ReservaHilos& hilos) {
+
+    // Se reparten los descuentos por fragmentos, conservando su orden dentro de cada uno
+    int m = ids.size();
+    vector< vector<int> > lista(NUM_FRAGMENTOS);
+    for (int j = 0; j < m; ++j) lista[fragmento(ids[j])].push_back(j);
+
+    // Cada fragmento se procesa en paralelo: solo toca sus jugadores y las casillas del
+    // ranking de estos, y anota los puntos de antes y de despues de cada descuento
+    vector<int> antes(m, -1), despues(m, 0), cat_antes(m, 0), cat_despues(m, 0);
+    vector<Jugador>& r = propio(rank);
+    hilos.ejecutar(NUM_FRAGMENTOS, [&](int f, int) {
+        if (lista[f].empty()) return;
+        MapaJugadores& frag = propio(fragmentos[f]);
+        for (int k = 0; k < (int)lista[f].size(); ++k) {
+            int j = lista[f][k];
+            MapaJugadores::iterator it = frag.find(ids[j]);
+            if (it != frag.end()) {
+                Jugador& jug = it->second;
+                int i = jug.consultar_posicion();
+                antes[j] = jug.consultar_puntos();
+                jug.rest(pts[j]);
+                r[i-1].rest(pts[j]);
+                despues[j] = jug.consultar_puntos();
+                if (cats[j] >= 1) {
+                    cat_antes[j] = jug.consultar_ptos_cat(cats[j]);
+                    jug.rest_cat(cats[j], pts[j]);
+                    r[i-1].rest_cat(cats[j], pts[j]);
+                    cat_despues[j] = jug.consultar_ptos_cat(cats[j]);
+                }
+            }
+        }
+    });
+
+    // Lo que comparten todos los fragmentos se actualiza despues, en el orden de los descuentos
+    for (int j = 0; j < m; ++j) {
+        if (antes[j] != -1) {
+            dist_ptos.sumar(antes[j], -1);
+            dist_ptos.sumar(despues[j], 1);
+            if (cats[j] >= 1) cambiar_en_categoria(ids[j], cats[j], cat_antes[j], cat_despues[j]);
+        }
+    }
+}
+
+void ConjuntoJugadores::reiniciar_puntos(ReservaHilos& hilos) {
+
+    vector<Jugador>& r = propio(rank);
+    hilos.ejecutar(NUM_FRAGMENTOS, [this, &r](int f, int) {
+        MapaJugadores& frag = propio(fragmentos[f]);
+        MapaJugadores::iterator it;
+        for (it = frag.begin(); it != frag.end(); ++it) {
+            it->second.anular_ptos();
+            r[it->second.consultar_posicion() - 1].anular_ptos();
+        }
+    });
+
+    rank_cat.clear();
+    dist_ptos = ArbolFenwick();
+    dist_ptos.sumar(0, njug);
+    actualizar_ranking(hilos);
+}
+
+void ConjuntoJugadores::iniciar_transaccion() {
+    transaccion = true;
+    registro.clear();
+}
+
+void ConjuntoJugadores::confirmar_transaccion() {
+    transaccion = false;
+    registro.clear();
+}
+
+void ConjuntoJugadores::deshacer_transaccion() {
+
+    // Durante la transaccion nadie cambia de posicion, asi que cada jugador
+    // anotado vuelve al mismo sitio del ranking
+    RegistroTransaccion::const_iterator it;
+    for (it = registro.begin(); it != registro.end(); ++it) {
+        Jugador& jug = jugador(it->first);
+        for (int c = 1; c <= (int)rank_cat.size(); ++c)
+            cambiar_en_categoria(it->first, c, jug.consultar_ptos_cat(c), it->second.first.consultar_ptos_cat(c));
+        dist_ptos.sumar(jug.consultar_puntos(), -1);
+        dist_ptos.sumar(it->second.first.consultar_puntos(), 1);
+        jug = it->second.first;
+        propio(rank)[it->second.first.consultar_posicion() - 1] = it->second.second;
+    }
+    transaccion = false;
+    registro.clear();
+}
+
+ConjuntoJugadores ConjuntoJugadores::instantanea() const{
+    ConjuntoJugadores c;
+    c.fragmentos = fragmentos;
+    c.rank = rank;
+    c.njug = njug;
+    return c;
+}
+
+bool ConjuntoJugadores::existe_jugador(string_view id_p) const{
+    const MapaJugadores& f = *fragmentos[fragmento(id_p)];
+    MapaJugadores::const_iterator it = f.find(id_p);
+    if (it != f.end()) return true;
     else return false;
 }
 
@@ -137,12 +552,68 @@ int ConjuntoJugadores::numero_jugadores() const{
     return njug;
 }
 
-Jugador ConjuntoJugadores::consultar_jugador(string& id_p) {
-    return map_jug[id_p];
+const Jugador& ConjuntoJugadores::consultar_jugador(string_view id_p) const{
+    return fragmentos[fragmento(id_p)]->find(id_p)->second;
+}
+
+const Jugador& ConjuntoJugadores::consultar_jugador_rank(int x) const{
+    return (*rank)[x-1];
+}
+
+int ConjuntoJugadores::contar_delante(int ptos, int pos) const{
+
+    // El ranking esta ordenado por puntos y posicion, asi que los que van por
+    // delante son un prefijo suyo y se puede buscar su longitud dicotomicamente
+    int ini = 0, fin = njug;
+    while (ini < fin) {
+        int m = (ini + fin)/2;
+        int p = (*rank)[m].consultar_puntos();
+        if (p > ptos or (p == ptos and m+1 < pos)) ini = m + 1;
+        else fin = m;
+    }
+    return ini;
+}
+
+int ConjuntoJugadores::contar_con_puntos(int x) const{
+    return dist_ptos.total() - dist_ptos.contar_menores(x);
+}
+
+int ConjuntoJugadores::contar_con_menos_puntos(int x) const{
+    return dist_ptos.contar_menores(x);
 }
 
-Jugador ConjuntoJugadores::consultar_jugador_rank(int x) const{
-    return rank[x-1];
+int ConjuntoJugadores::puntos_corte(int k) const{
+    return dist_ptos.kesimo(dist_ptos.total() - k + 1);
+}
+
+void ConjuntoJugadores::listar_ranking_categoria(int c, ostream& os) const{
+    if (c > (int)rank_cat.size()) return;
+    int pos = 1;
+    RankingCategoria::const_iterator it;
+    for (it = rank_cat[c-1].begin(); it != rank_cat[c-1].end(); ++it, ++pos)
+        os << pos << ' ' << it->second << ' ' << -it->first << endl;
+}
+
+void ConjuntoJugadores::listar_ranking_elo(ostream& os) const{
+
+    // El rating no se mantiene ordenado, para no encarecer los partidos: se ordena al consultarlo
+    vector<pair<double, const string*> > v;
+    v.reserve(njug);
+    for (int f = 0; f < NUM_FRAGMENTOS; ++f) {
+        MapaJugadores::const_iterator it;
+        for (it = fragmentos[f]->begin(); it != fragmentos[f]->end(); ++it)
+            v.push_back(make_pair(-it->second.consultar_elo(), &it->first));
+    }
+    sort(v.begin(), v.end(), [](const pair<double, const string*>& x, const pair<double, const string*>& y) {
+        return x.first < y.first or (x.first == y.first and *x.second < *y.second);
+    });
+
+    ios_base::fmtflags flags = os.flags();
+    streamsize prec = os.precision();
+    os << fixed << setprecision(1);
+    for (int i = 0; i < (int)v.size(); ++i) os << i+1 << ' ' << *v[i].second << ' ' << -v[i].first << endl;
+    os.flags(flags);
+    os.precision(prec);
 }
 
 void ConjuntoJugadores::leer_jugadores() {
@@ -150,21 +621,102 @@ void ConjuntoJugadores::leer_jugadores() {
     for (int i = 1; i <= njug; ++i) {
         cin >> name;
         Jugador jug(name,i);
-        map_jug.insert(make_pair(name, jug));
-        rank.push_back(jug);
+        propio(fragmentos[fragmento(name)]).insert(make_pair(name, jug));
+        propio(rank).push_back(jug);
     }
+    dist_ptos.sumar(0, njug);
 }
 
-void ConjuntoJugadores::listar_ranking() const{
+bool ConjuntoJugadores::cargar_jugadores(const string& fichero) {
+
+    vector<string> nombres;
+    if (not Tokenizador::leer_fichero(fichero, nombres)) return false;
+
+    // Se ordenan los nombres junto con su orden de aparicion en el fichero;
+    // asi los repetidos quedan juntos con la primera aparicion delante
+    int n = nombres.size();
+    vector< pair<string,int> > ord(n);
+    for (int i = 0; i < n; ++i) ord[i] = make_pair(move(nombres[i]), i);
+    sort(ord.begin(), ord.end());
+
+    // En una sola pasada por cada fragmento (tambien ordenado) se descartan los repetidos
+    // y los que ya existian, y se insertan los nuevos con la posicion siguiente como pista;
+    // los nombres de un mismo fragmento siguen ordenados dentro de "ord"
+    vector<Jugador*> nuevo(n, NULL);
+    vector<MapaJugadores::iterator> it(NUM_FRAGMENTOS);
+    for (int f = 0; f < NUM_FRAGMENTOS; ++f) it[f] = propio(fragmentos[f]).begin();
+    for (int k = 0; k < n; ++k) {
+        if (k > 0 and ord[k].first == ord[k-1].first) continue;
+        int f = fragmento(ord[k].first);
+        while (it[f] != fragmentos[f]->end() and it[f]->first < ord[k].first) ++it[f];
+        if (it[f] == fragmentos[f]->end() or it[f]->first != ord[k].first) 
+            nuevo[ord[k].second] = &fragmentos[f]->insert(it[f], make_pair(ord[k].first, Jugador(ord[k].first)))->second;
+    }
+
+    // Los nuevos jugadores se añaden al final del ranking en el orden del fichero
+    vector<Jugador>& r = propio(rank);
+    r.reserve(njug + n);
+    for (int i = 0; i < n; ++i) {
+        if (nuevo[i] != NULL) {
+            ++njug;
+            nuevo[i]->modificar_posicion(njug);
+            r.push_back(*nuevo[i]);
+            dist_ptos.sumar(0, 1);
+        }
+    }
+    return true;
+}
+
+void ConjuntoJugadores::listar_ranking(ostream& os) const{
     for (int i = 0; i < njug; ++i) 
-        cout << i+1 << ' ' << rank[i].consultar_nombre() << ' ' << rank[i].consultar_puntos() << endl;
+        os << i+1 << ' ' << (*rank)[i].consultar_nombre() << ' ' << (*rank)[i].consultar_puntos() << endl;
     
 }
 
-void ConjuntoJugadores::listar_jugadores() {
-    cout << njug << endl;
-    map<string, Jugador>::iterator it;
-    for (it = map_jug.begin(); it != map_jug.end(); ++it)  
-        it->second.listar_jugador();
+void ConjuntoJugadores::listar_jugadores(ostream& os) const{
+    os << njug << endl;
+
+    // Los fragmentos estan ordenados por nombre, asi que se mezclan escribiendo cada
+    // vez el menor de los primeros jugadores que quedan de cada uno
+    vector<MapaJugadores::const_iterator> it(NUM_FRAGMENTOS);
+    for (int f = 0; f < NUM_FRAGMENTOS; ++f) it[f] = fragmentos[f]->begin();
+    int m = 0;
+    while (m != -1) {
+        m = -1;
+        for (int f = 0; f < NUM_FRAGMENTOS; ++f)
+            if (it[f] != fragmentos[f]->end() and (m == -1 or it[f]->first < it[m]->first)) m = f;
+        if (m != -1) {
+            it[m]->second.listar_jugador(os);
+            ++it[m];
+        }
+    }
+}
+
+void ConjuntoJugadores::buscar_jugadores(string_view prefijo, ostream& os) const{
+
+    // En cada fragmento, ordenado por nombre, los que empiezan por el prefijo forman un
+    // tramo [it[f], fin[f]) que empieza en el primer nombre que no es menor que el prefijo
+    vector<MapaJugadores::const_iterator> it(NUM_FRAGMENTOS), fin(NUM_FRAGMENTOS);
+    int n = 0;
+    for (int f = 0; f < NUM_FRAGMENTOS; ++f) {
+        it[f] = fin[f] = fragmentos[f]->lower_bound(prefijo);
+        while (fin[f] != fragmentos[f]->end() and fin[f]->first.compare(0, prefijo.size(), prefijo) == 0) {
+            ++fin[f];
+            ++n;
+        }
+    }
+    os << n << endl;
+
+    // Los tramos se mezclan igual que los fragmentos enteros en listar_jugadores
+    int m = 0;
+    while (m != -1) {
+        m = -1;
+        for (int f = 0; f < NUM_FRAGMENTOS; ++f)
+            if (it[f] != fin[f] and (m == -1 or it[f]->first < it[m]->first)) m = f;
+        if (m != -1) {
+            it[m]->second.listar_jugador(os);
+            ++it[m];
+        }
+    }
 }
 
@@ -6,25 +6,115 @@
 
 #include "Jugador.hh"
 #include "Categoria.hh"
+#include "ArbolFenwick.hh"
+#include "ReservaHilos.hh"
+#include "Compartido.hh"
+
+#ifndef NO_DIAGRAM
+#include <memory>
+#include <set>
+#include <string_view>
+#endif
 
 /** @class ConjuntoJugadores
     @brief Representa un conjunto de jugadores.
-    Contiene un map que representa al conjunto de jugadores ordenados
-    crecientemente por nombre. Y un vector de jugadores 
-    denominado rank, representa el ranking ordenado 
-    decrecientemente por puntos del jugador
+    Contiene los jugadores repartidos en NUM_FRAGMENTOS maps según el hash de su
+    nombre, cada uno ordenado crecientemente por nombre, para que las operaciones
+    sobre muchos jugadores se puedan hacer en paralelo por fragmentos. Y un vector
+    de jugadores denominado rank, representa el ranking ordenado 
+    decrecientemente por puntos del jugador.
+    Los fragmentos y el ranking se comparten con las instantáneas (ver
+    <em>instantanea</em>) y solo se copian cuando se modifican mientras alguna los usa.
 */    
 class ConjuntoJugadores {
     
 private:
+
+    /** @brief map de <em>Jugador</em> por nombre */
+    typedef map<string, Jugador, less<> > MapaJugadores;
+
+    /** @brief Ranking de una categoría */
+    typedef set< pair<int, string> > RankingCategoria;
+
+    /** @brief Registro de una transacción */
+    typedef map<string, pair<Jugador, Jugador> > RegistroTransaccion;
     
-    /** @brief map de <em>Jugador</em> que contiene todos los jugadores del conjunto inscritos en el circuito */
-    map<string,Jugador> map_jug;
+    /** @brief Rating que se juega en cada partido */
+    static const int K_ELO = 32;
+
+    /** @brief Número de fragmentos en los que se reparten los jugadores */
+    static const int NUM_FRAGMENTOS = 8;
+
+    /** @brief maps de <em>Jugador</em> que contienen todos los jugadores del conjunto inscritos
+        en el circuito: cada jugador está en el fragmento que indica <em>fragmento</em> */
+    vector< shared_ptr<MapaJugadores> > fragmentos;
 
     /** @brief vector de <em>Jugador</em> que representa el ranking de los jugadores ordenado decrecientemente por puntos */
-    vector<Jugador> rank;
+    shared_ptr< vector<Jugador> > rank;
     
     int njug;
+
+    /** @brief Indica si hay una transacción abierta */
+    bool transaccion;
+
+    /** @brief Registro para deshacer la transacción abierta: para cada jugador modificado,
+        su estado en el map y en el ranking antes de la primera modificación */
+    RegistroTransaccion registro;
+
+    /** @brief Ranking de cada categoría: rank_cat[c-1] contiene, para cada jugador con puntos
+        de la categoría c, la pareja (-puntos, nombre), así que está ordenado decrecientemente
+        por puntos y crecientemente por nombre en caso de empate */
+    vector<RankingCategoria> rank_cat;
+
+    /** @brief Puntos de todos los jugadores del conjunto, para contar cuántos hay por
+        encima o por debajo de unos puntos sin recorrer el ranking */
+    ArbolFenwick dist_ptos;
+
+    /** @brief Indica si se están aplazando las reordenaciones del ranking */
+    bool aplazando;
+
+    /** @brief Número de reordenaciones aplazadas desde la última que se ha hecho */
+    int aplazadas;
+
+    /** @brief Para cada casilla de "rank" que ha cambiado de puntos desde la última
+        reordenación, parejas (e, p): desde la reordenación aplazada e tenía p puntos.
+        La primera es (0, puntos antes del primer cambio), o (0, INT_MIN) si el jugador
+        se ha añadido con alguna reordenación ya aplazada */
+    vector< vector< pair<int, int> > > ptos_aplazados;
+
+    /** @brief Casillas con cambios desde la última reordenación y, de ellas, las que han
+        cambiado desde la última aplazada; "toque" indica la última aplazada + 1 en la que
+        se ha añadido cada casilla a "tocados_ultima" */
+    vector<int> tocados;
+    vector<int> tocados_ultima;
+    vector<int> toque;
+
+    /** @brief Función privada que calcula el fragmento de un jugador
+        \pre <em>Cierto</em>
+        \post El resultado es el fragmento (entre 0 y NUM_FRAGMENTOS - 1) en el que está o
+        estaría el jugador "id_p"
+    */
+    static int fragmento(string_view id_p);
+
+    /** @brief Función privada que accede a un jugador de los fragmentos
+        \pre Existe el jugador "id_p"
+        \post El resultado es el jugador "id_p" de su fragmento
+    */
+    Jugador& jugador(string_view id_p);
+
+    /** @brief Función privada que actualiza el ranking de una categoría
+        \pre c >= 1, y el jugador "id_p" tenía "antes" puntos en la categoría c
+        \post El jugador "id_p" aparece en el ranking de la categoría c con "despues" puntos,
+        o no aparece si "despues" es 0
+    */
+    void cambiar_en_categoria(const string& id_p, int c, int antes, int despues);
+
+    /** @brief Función privada que anota un jugador en el registro de la transacción
+        \pre <em>Cierto</em>
+        \post Si hay una transacción abierta, existe el jugador "id_p" y todavía no está
+        en el registro, se ha anotado su estado actual
+    */
+    void anotar(const string& id_p);
     
     /** @brief Función privada que intercambia dos jugadores del ranking
         \pre 'x' y 'y' son dos posiciones del ranking "rank"
@@ -39,6 +129,39 @@ private:
         y crecientemente por la posicion anterior en caso de empate
     */
     static bool cmp(Jugador& a, Jugador& b);
+
+    /** @brief Función privada que anota que va a cambiar una casilla del ranking
+        \pre 'i' es un índice de "rank"
+        \post Si se están aplazando las reordenaciones, 'i' está en "tocados_ultima" y
+        en "ptos_aplazados" están sus puntos de antes del primer cambio
+    */
+    void tocar(int i);
+
+    /** @brief Función privada que compara dos casillas del ranking con reordenaciones aplazadas
+        \pre 'x' y 'y' son dos índices de "rank"
+        \post El resultado indica si el jugador de la casilla 'x' quedaría por delante del de
+        la casilla 'y' si se hubieran hecho una detrás de otra todas las reordenaciones
+        aplazadas: tiene más puntos en la última, o los mismos y más en la anterior, y así
+        hasta la posición que tenían antes de la primera
+    */
+    bool delante_aplazado(int x, int y) const;
+
+    /** @brief Función privada que ordena las casillas del ranking por puntos con radix sort
+        \pre Si "hilos" no es NULL, se puede usar para repartir el trabajo
+        \post "orden" contiene los índices de "rank" ordenados decrecientemente por puntos y,
+        en caso de empate, crecientemente por la posición que guarda cada casilla (si
+        "por_posicion") o por el índice (si no)
+    */
+    void ordenar_por_puntos(vector<int>& orden, bool por_posicion, ReservaHilos* hilos) const;
+
+    /** @brief Función privada que coloca el ranking en un orden nuevo
+        \pre "orden" es una permutación de los índices de "rank", y la posición que guarda
+        cada jugador de los fragmentos es su índice en "rank" + 1. Si "hilos" no es NULL,
+        se puede usar para repartir el trabajo
+        \post La casilla i de "rank" tiene el jugador que tenía la casilla orden[i], y la
+        posición de cada jugador, en "rank" y en los fragmentos, es su casilla + 1
+    */
+    void aplicar_orden(const vector<int>& orden, ReservaHilos* hilos);
     
     
 public:
@@ -67,14 +190,14 @@ public:
         \post Se ha añadido un Jugador con identificador = id_p y estadísticas a 0
         al conjunto de jugadores y se ha actualizado el ranking añadiendo este Jugador
     */
-    void nuevo_jugador(string& id_p);
+    void nuevo_jugador(string_view id_p);
     
     /** @brief Se elimina a un Jugador del conjunto de jugadores
         \pre Existe un Jugador con identificador = id_p en el conjunto de jugadores
         \post Se ha eliminado al Jugador con identificador = id_p del conjunto de jugadores
         y se ha actualizado el ranking eliminando al jugador del mismo
     */
-    void baja_jugador(string& id_p);
+    void baja_jugador(string_view id_p);
     
     /** @brief Se actualiza el ranking 
         Se ordena decrecientemente por puntos del Jugador y decrecientemente
@@ -84,6 +207,47 @@ public:
         decrecientemente por puntos del Jugador
     */
     void actualizar_ranking();
+
+    /** @brief Se actualiza el ranking después de quitar puntos a unos pocos jugadores
+        Da el mismo ranking que <em>actualizar_ranking</em>, pero solo reordena a los
+        jugadores que han perdido puntos y a los que van por detrás del primero de ellos
+        \pre El ranking estaba actualizado antes de restar puntos a los jugadores con
+        identificador en "rebajados", y nadie más ha cambiado de puntos
+        \post Se ha ordenado el ranking decrecientemente por puntos y crecientemente por
+        la posición anterior en caso de empate
+    */
+    void actualizar_ranking(const vector<string>& rebajados);
+
+    /** @brief Se reconstruye el ranking entero en paralelo
+        Se ordenan claves compactas (puntos e índice) con un radix sort LSD repartido entre
+        los hilos, y después se colocan los jugadores y sus posiciones
+        \pre Ranking inicializado
+        \post Se ha ordenado el ranking decrecientemente por puntos y, en caso de empate,
+        por el orden que tenían en el ranking
+    */
+    void actualizar_ranking(ReservaHilos& hilos);
+
+    /** @brief Se empiezan a aplazar las reordenaciones del ranking
+        \pre El ranking está actualizado
+        \post Hasta <em>acabar_aplazamiento</em>, las reordenaciones se pueden aplazar con
+        <em>aplazar_ranking</em>
+    */
+    void iniciar_aplazamiento();
+
+    /** @brief Se aplaza una reordenación del ranking
+        \pre Se están aplazando las reordenaciones y solo han cambiado los puntos con
+        <em>sumar_puntos</em>, <em>restar</em> y <em>deshacer_transaccion</em>
+        \post Se han guardado los puntos de los jugadores que han cambiado, y el siguiente
+        <em>actualizar_ranking</em>() deja el mismo ranking que si en lugar de esta operación
+        y de las anteriores aplazadas se hubiera hecho un <em>actualizar_ranking</em>() cada vez
+    */
+    void aplazar_ranking();
+
+    /** @brief Se dejan de aplazar las reordenaciones del ranking
+        \pre El ranking está actualizado
+        \post Las reordenaciones ya no se pueden aplazar
+    */
+    void acabar_aplazamiento();
     
     /** @brief Se suman y se restan los juegos pertenecientes a los dos jugadores pasados como parámetro
         \pre 'a' y 'b' son dos enteros que representan dos jugadores participantes, 
@@ -100,34 +264,85 @@ public:
     void sumar_restar_set(int a, int b, const vector<Jugador>& part);
     
     /** @brief Se suman y se restan los partidos a los dos jugadores pasados como parámetro
-        \pre 'a' y 'b' son dos enteros que representan dos jugadores participantes
-        y "part" es el vector de participantes del torneo
-        \post Se han sumado y restado los partidos correspondientes a los dos jugadores
+        \pre 'a' y 'b' son dos enteros que representan dos jugadores participantes, 'a' el
+        ganador, y "part" es el vector de participantes del torneo
+        \post Se han sumado y restado los partidos correspondientes a los dos jugadores. Si
+        el partido se ha "jugado" (no es un partido ganado sin jugar), 'a' ha ganado en su
+        rating K_ELO por lo que no se esperaba su victoria, y 'b' lo ha perdido
     */
-    void sumar_restar_partido(int a, int b, const vector<Jugador>& part);
+    void sumar_restar_partido(int a, int b, bool jugado, const vector<Jugador>& part);
     
     /** @brief Se suman y se restan los puntos pertenecientes a los dos jugadores pasados como parámetro
         \pre 'a' es un enteros que representa un jugador participante, "cat" es la Categoria a la que pertenece el Torneo, 
         "nivel" es el nivel para sumar los puntos correspondientes y "part" es el vector de participantes del Torneo
         \post Se han sumado los puntos pertenecientes al nivel pasado como parámetro al Jugador 'a'
     */
-    void sumar_puntos(Categoria& cat, int nivel, int a, vector<Jugador>& part);
+    void sumar_puntos(const Categoria& cat, int nivel, int a, vector<Jugador>& part);
     
     /** @brief Se restan los puntos pertenecientes al Jugador con identificador "id_p"
-        \pre "id_p" es un string que representa el identificador del Jugador, y "pt" los puntos que se le deben restar
-        \post Se han sumado los puntos pertenecientes al nivel pasado como parámetro al Jugador 'a'
+        \pre "id_p" es un string que representa el identificador del Jugador, "pt" los puntos que se
+        le deben restar y 'c' la categoría en la que los había conseguido
+        \post Si existe el Jugador, se le han restado los puntos, sin bajar de 0, del total y
+        de la categoría 'c'
+    */
+    void restar(string_view id_p, int pt, int c);
+
+    /** @brief Se restan puntos a muchos jugadores a la vez
+        Cada fragmento aplica en paralelo los descuentos de sus jugadores
+        \pre No hay ninguna transacción abierta, y "ids", "pts" y "cats" tienen el mismo tamaño
+        \post El resultado es el mismo que llamar a <em>restar</em>(ids[j], pts[j], cats[j])
+        para cada j en orden creciente
+    */
+    void restar_varios(const vector<string>& ids, const vector<int>& pts,
+                       const vector<int>& cats, ReservaHilos& hilos);
+
+    /** @brief Se reinician los puntos de todos los jugadores para empezar una temporada
+        \pre No hay ninguna transacción abierta
+        \post Todos los jugadores tienen 0 puntos, en total y en cada categoría, y el
+        ranking está actualizado
     */
-    void restar(string& id_p, int pt);
+    void reiniciar_puntos(ReservaHilos& hilos);
+
+    /** @brief Se abre una transacción
+        Mientras está abierta, se anota el estado anterior de los jugadores que se modifican
+        con <em>sumar_restar_juegos</em>, <em>sumar_restar_set</em>, <em>sumar_restar_partido</em>,
+        <em>sumar_puntos</em> y <em>restar</em>, que son las únicas modificaciones permitidas
+        \pre No hay ninguna transacción abierta
+        \post Hay una transacción abierta sin ningún jugador modificado
+    */
+    void iniciar_transaccion();
+
+    /** @brief Se cierra la transacción conservando sus cambios
+        \pre Hay una transacción abierta
+        \post No hay ninguna transacción abierta y los jugadores no han cambiado
+    */
+    void confirmar_transaccion();
+
+    /** @brief Se cierra la transacción deshaciendo sus cambios
+        \pre Hay una transacción abierta
+        \post No hay ninguna transacción abierta y los jugadores modificados durante la
+        transacción han recuperado el estado que tenían al abrirla
+    */
+    void deshacer_transaccion();
     
     
     // Consultores
     
+    /** @brief Operacion de consulta de una instantánea del conjunto
+        \pre <em>Cierto</em>
+        \post El resultado tiene los mismos jugadores y el mismo ranking que el conjunto,
+        compartidos con él hasta que alguno de los dos los modifique, y solo sirve para
+        <em>existe_jugador</em>, <em>consultar_jugador</em>, <em>listar_ranking</em>,
+        <em>listar_jugadores</em> y <em>buscar_jugadores</em>
+    */
+    ConjuntoJugadores instantanea() const;
+    
     /** @brief Operacion de consulta
         \pre <em>Cierto</em>
         \post El resultado indica si existe un Jugador con id = id_p en el 
         conjunto de jugadores
     */
-    bool existe_jugador(string& id_p);
+    bool existe_jugador(string_view id_p) const;
     
     /** @brief Operacion de consulta del numero de jugadores del conjunto
         \pre <em>Cierto</em>
@@ -137,15 +352,60 @@ public:
     
     /** @brief Operacion de consulta de un Jugador
         \pre Existe un Jugador con identificador id_p en el circuito
-        \post Se ha devuelto el Jugador con identificador id_p
+        \post Se ha devuelto el Jugador con identificador id_p, sin copiarlo: la referencia
+        deja de ser válida al modificar el conjunto
     */
-    Jugador consultar_jugador(string& id_p);
+    const Jugador& consultar_jugador(string_view id_p) const;
     
     /** @brief Se consulta cuál es el Jugador con posición x del ranking
         \pre x >= 1 y x <= num. de jugadores
-        \post El resultado es un Jugador que está en la posición x del ranking
+        \post El resultado es un Jugador que está en la posición x del ranking, sin copiarlo:
+        la referencia deja de ser válida al modificar el conjunto
+    */
+    const Jugador& consultar_jugador_rank(int x) const;
+
+    /** @brief Cuenta los jugadores del ranking que irían por delante de uno dado
+        \pre pos >= 1 y el ranking está actualizado
+        \post El resultado es el número de jugadores del ranking actual que quedarían por
+        delante de un jugador con "ptos" puntos y posición anterior "pos" al ordenar el ranking
+    */
+    int contar_delante(int ptos, int pos) const;
+
+    /** @brief Cuenta los jugadores con al menos unos puntos
+        \pre <em>Cierto</em>
+        \post El resultado es el número de jugadores del conjunto con 'x' puntos o más
+    */
+    int contar_con_puntos(int x) const;
+
+    /** @brief Cuenta los jugadores con menos puntos que un valor
+        \pre <em>Cierto</em>
+        \post El resultado es el número de jugadores del conjunto con menos de 'x' puntos
+    */
+    int contar_con_menos_puntos(int x) const;
+
+    /** @brief Consulta los puntos de corte de una posición del ranking
+        \pre 1 <= k <= número de jugadores
+        \post El resultado son los puntos del jugador que ocupa la posición k al ordenar el
+        conjunto decrecientemente por puntos, es decir, los puntos mínimos para estar entre
+        los k primeros
+    */
+    int puntos_corte(int k) const;
+
+    /** @brief Operación de escritura del ranking de una categoría
+        \pre c >= 1
+        \post Se han escrito a través del canal "os" la posición, el nombre y los puntos de la
+        categoría c de los jugadores que tienen alguno, decrecientemente por puntos y
+        crecientemente por nombre en caso de empate
     */
-    Jugador consultar_jugador_rank(int x) const;
+    void listar_ranking_categoria(int c, ostream& os) const;
+
+    /** @brief Operación de escritura del ranking por rating
+        \pre <em>Cierto</em>
+        \post Se han escrito a través del canal "os" la posición, el nombre y el rating (con
+        un decimal) de todos los jugadores, decrecientemente por rating y crecientemente
+        por nombre en caso de empate
+    */
+    void listar_ranking_elo(ostream& os) const;
     
 
     // Lectura y escritura
@@ -158,22 +418,41 @@ public:
         Jugador en la posición en la que se ha leído
     */
     void leer_jugadores();
+
+    /** @brief Operacion de carga masiva
+        Se añaden al conjunto los jugadores cuyos nombres contiene un fichero
+        \pre <em>Cierto</em>
+        \post Si el fichero "fichero" se ha podido abrir, se han añadido al conjunto, 
+        con estadísticas a 0 y al final del ranking en el orden del fichero, los 
+        jugadores del fichero que no existían antes (los nombres repetidos se cuentan 
+        una sola vez) y el resultado es cierto; si no, el resultado es falso
+    */
+    bool cargar_jugadores(const string& fichero);
     
     /** @brief Operacion de escritura
         Se lista el ranking por orden creciente de posición escribiendo el nombre y los
         puntos de cada Jugador
         \pre Ranking inicializado
-        \post Se ha escrito a través del canal estándar de salida el nombre y los puntos de
+        \post Se ha escrito a través del canal "os" el nombre y los puntos de
         cada Jugador ordenado crecientemente por su posición en el ranking
     */
-    void listar_ranking() const;
+    void listar_ranking(ostream& os) const;
     
     /** @brief Se listan todos los jugadores del conjunto de jugadores
         \pre <em>Cierto</em>
         \post Para cada jugador del conjunto y por orden creciente de nombre, 
-        se ha escrito a través del canal estándar de salida su nombre, posición 
+        se ha escrito a través del canal "os" su nombre, posición 
         en el ranking, puntos, y el resto de estadísticas del jugador en el circuito
     */
-    void listar_jugadores();
+    void listar_jugadores(ostream& os) const;
+
+    /** @brief Se listan los jugadores cuyo nombre empieza por un prefijo
+        \pre <em>Cierto</em>
+        \post Se ha escrito a través del canal "os" el número de jugadores del conjunto cuyo
+        nombre empieza por "prefijo" y, por orden creciente de nombre, la misma línea que en
+        <em>listar_jugadores</em> de cada uno. El coste es logarítmico en el número de
+        jugadores más lineal en el de los que se escriben
+    */
+    void buscar_jugadores(string_view prefijo, ostream& os) const;
 };
 #endif
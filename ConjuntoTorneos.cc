@@ -2,42 +2,76 @@
     @brief Código de la clase ConjuntoTorneos */
 
 #include "ConjuntoTorneos.hh"
+#include "Tokenizador.hh"
+#ifndef NO_DIAGRAM
+#include <algorithm>
+#include <cstdlib>
+#endif
 
 ConjuntoTorneos::ConjuntoTorneos() {
+    map_tor = make_shared<MapaTorneos>();
     ntor = 0;
+    ediciones = 0;
 }
 
 ConjuntoTorneos::ConjuntoTorneos(int t) {
+    map_tor = make_shared<MapaTorneos>();
     ntor = t;
+    ediciones = 0;
 }
 
-void ConjuntoTorneos::nuevo_torneo(string& id, Categoria& cat) {
-    Torneo torn(id, cat);
-    map_tor.insert(make_pair(id, torn));
+void ConjuntoTorneos::nuevo_torneo(string_view id, const Categoria& cat) {
+    Torneo torn(string(id), cat);
+    propio(map_tor).emplace(id, move(torn));
     ++ntor;
 }
 
-void ConjuntoTorneos::baja_torneo(string& id) {
-    map_tor.erase(id);
+void ConjuntoTorneos::baja_torneo(string_view id) {
+    MapaTorneos& m = propio(map_tor);
+    m.erase(m.find(id));
     --ntor;
 }
 
-void ConjuntoTorneos::definir_cuadro_y_participantes(string& id_to, const BinTree<int>& arb, const vector<Jugador>& r) {
+void ConjuntoTorneos::definir_cuadro_y_participantes(string_view id_to, vector<int> pre, vector<int> der, vector<Jugador> r) {
 
-    // Se asignan al torneo del conjunto el arbol de emparejamientos y el vector de participantes
-    map_tor[id_to].asignar_cuadro_emp_participantes(arb,r);
+    // Se asignan al torneo del conjunto el cuadro de emparejamientos y el vector de participantes
+    propio(map_tor).find(id_to)->second.asignar_cuadro_emp_participantes(move(pre), move(der), move(r));
 }
 
-void ConjuntoTorneos::definir_ult_jugadores(string& id_to, Torneo& torn) {
+void ConjuntoTorneos::definir_ult_jugadores(string_view id_to, const Torneo& torn) {
 
     // Se asigna al torneo del conjunto el vector de participantes de la ultima edicion
-    vector<Jugador> last = torn.consultar_participantes();
-    map_tor[id_to].ult_jugadores(last);
+    ++ediciones;
+    propio(map_tor).find(id_to)->second.ult_jugadores(torn.consultar_participantes(), ediciones);
 }
 
-bool ConjuntoTorneos::existe_torneo(string& id) {
-    map<string, Torneo>::iterator it = map_tor.find(id);
-    if (it != map_tor.end()) return true;
+bool ConjuntoTorneos::caducar_puntos(string_view id_to, int ed, int i, string& id_p, int& pt, int& c) {
+
+    // Si el torneo se ha dado de baja o se ha vuelto a finalizar, sus puntos ya se han restado
+    MapaTorneos::const_iterator ct = map_tor->find(id_to);
+    if (ct == map_tor->end() or ct->second.consultar_edicion() != ed) return false;
+    MapaTorneos::iterator it = propio(map_tor).find(id_to);
+    it->second.caducar_puntos(i, id_p, pt);
+    c = it->second.consultar_id_categoria();
+    return true;
+}
+
+void ConjuntoTorneos::anular_puntos() {
+    MapaTorneos& m = propio(map_tor);
+    MapaTorneos::iterator it;
+    for (it = m.begin(); it != m.end(); ++it) it->second.anular_puntos();
+}
+
+void ConjuntoTorneos::definir_formato(int ca, Categoria::Formato f) {
+    MapaTorneos& m = propio(map_tor);
+    MapaTorneos::iterator it;
+    for (it = m.begin(); it != m.end(); ++it)
+        if (it->second.consultar_id_categoria() == ca) it->second.definir_formato(f);
+}
+
+bool ConjuntoTorneos::existe_torneo(string_view id) const{
+    MapaTorneos::const_iterator it = map_tor->find(id);
+    if (it != map_tor->end()) return true;
     else return false;
 }
 
@@ -45,8 +79,19 @@ int ConjuntoTorneos::numero_torneos() const{
     return ntor;
 }
 
-Torneo ConjuntoTorneos::consultar_torneo(string& id_to) {
-    return map_tor[id_to];
+const Torneo& ConjuntoTorneos::consultar_torneo(string_view id_to) const{
+    return map_tor->find(id_to)->second;
+}
+
+int ConjuntoTorneos::consultar_edicion(string_view id_to) const{
+    return map_tor->find(id_to)->second.consultar_edicion();
+}
+
+void ConjuntoTorneos::consultar_iniciados(vector<Torneo>& v) const{
+    v.clear();
+    MapaTorneos::const_iterator it;
+    for (it = map_tor->begin(); it != map_tor->end(); ++it)
+        if (it->second.esta_iniciado()) v.push_back(it->second);
 }
 
 void ConjuntoTorneos::leer_torneos(map<int, Categoria>& map_cat) {
@@ -55,17 +100,47 @@ void ConjuntoTorneos::leer_torneos(map<int, Categoria>& map_cat) {
     for (int i = 1; i <= ntor; ++i) {
         cin >> name;
         cin >> cat;
-        Categoria ct = map_cat[cat];
-        Torneo torn(name, ct);
-        map_tor.insert(make_pair(name, torn));
+        propio(map_tor).emplace(name, Torneo(name, map_cat[cat]));
+    }
+}
+
+ConjuntoTorneos::Carga ConjuntoTorneos::cargar_torneos(const string& fichero, map<int, Categoria>& map_cat) {
+
+    vector<string> tokens;
+    if (not Tokenizador::leer_fichero(fichero, tokens)) return NO_ABIERTO;
+    if (tokens.size()%2 != 0) return MAL_FORMADO;
+
+    // Se ordenan los nombres junto con su orden de aparicion en el fichero
+    int n = tokens.size()/2;
+    vector< pair<string,int> > ord(n);
+    for (int i = 0; i < n; ++i) ord[i] = make_pair(move(tokens[2*i]), i);
+    sort(ord.begin(), ord.end());
+
+    // Se recorre el mapa a la vez que los nombres ordenados para descartar los 
+    // repetidos y los que ya existen, insertando los nuevos con pista. De los repetidos
+    // cuenta la primera aparicion con categoria valida: las que no tienen no se aceptan
+    MapaTorneos& m = propio(map_tor);
+    MapaTorneos::iterator it = m.begin();
+    int aceptado = -1;
+    for (int k = 0; k < n; ++k) {
+        if (aceptado != -1 and ord[k].first == ord[aceptado].first) continue;
+        map<int, Categoria>::iterator ct = map_cat.find(atoi(tokens[2*ord[k].second+1].c_str()));
+        if (ct == map_cat.end()) continue;
+        aceptado = k;
+        while (it != m.end() and it->first < ord[k].first) ++it;
+        if (it == m.end() or it->first != ord[k].first) {
+            m.insert(it, make_pair(ord[k].first, Torneo(ord[k].first, ct->second)));
+            ++ntor;
+        }
     }
+    return CARGADO;
 }
 
-void ConjuntoTorneos::listar_torneos() {
-    cout << ntor << endl;
-    map<string, Torneo>::iterator it;
-    for (it = map_tor.begin(); it != map_tor.end(); ++it) 
-        it->second.listar_torneo();
+void ConjuntoTorneos::listar_torneos(ostream& os) const{
+    os << ntor << endl;
+    MapaTorneos::const_iterator it;
+    for (it = map_tor->begin(); it != map_tor->end(); ++it) 
+        it->second.listar_torneo(os);
 }
 
 
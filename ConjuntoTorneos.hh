@@ -5,20 +5,37 @@
 #define CONJUNTO_TORNEOS_HH
 
 #include "Torneo.hh"
+#include "Compartido.hh"
 
 /** @class ConjuntoTorneos
     @brief Representa un conjunto de torneos.
     Conjunto de torneos ordenados crecientemente por nombre. 
     Se puede modificar añadiendo o eliminando torneos, consultar si existe 
-    un determinado torneo o consultar el número de elementos del conjunto. */
+    un determinado torneo o consultar el número de elementos del conjunto.
+    Las copias del conjunto comparten el map de torneos hasta que alguna lo modifica. */
 class ConjuntoTorneos {
+
+public:
+
+    /** @brief Resultados de <em>cargar_torneos</em> */
+    enum Carga {
+        CARGADO,
+        NO_ABIERTO,
+        MAL_FORMADO
+    };
     
 private:
 
+    /** @brief map de <em>Torneo</em> por nombre */
+    typedef map<string, Torneo, less<> > MapaTorneos;
+
     /** @brief map de <em>Torneo</em> que representa el conjunto de torneos y contiene todos los del circuito */
-    map<string, Torneo> map_tor;
+    shared_ptr<MapaTorneos> map_tor;
     
     int ntor;
+
+    /** @brief Número de ediciones finalizadas en el circuito, que sirve para numerarlas */
+    int ediciones;
     
 
 public:
@@ -47,27 +64,50 @@ public:
         \post El resultado es el conjunto de los torneos anteriores y el añadido 
         con identificador id y de Categoria cat
     */
-    void nuevo_torneo(string& id, Categoria& cat);
+    void nuevo_torneo(string_view id, const Categoria& cat);
     
     /** @brief Se elimina un Torneo con identificador id del conjunto de torneos
         \pre Existe un torneo con identificador id
         \post El resultado es el conjunto de torneos sin el Torneo con identificador id
     */
-    void baja_torneo(string& id);
+    void baja_torneo(string_view id);
     
     /** @brief Se asigna el cuadro de emparejamientos y los participantes al <em>Torneo</em> requerido
-        \pre "id_to" es un string que representa el nombre de un Torneo, "arb" es el cuadro de emparejamientos de este Torneo 
+        \pre "id_to" es un string que representa el nombre de un Torneo, "pre" y "der" son el cuadro de
+        emparejamientos de este Torneo en preorden (ver <em>Torneo::definir_emparejamientos</em>)
         y 'r' es el vector de participantes
         \post Se ha asignado el cuadro de emparejamientos y el vector de participantes al <em>Torneo</em> 
         con identificador "id_to"
     */
-    void definir_cuadro_y_participantes(string& id_to, const BinTree<int>& arb, const vector<Jugador>& r);
+    void definir_cuadro_y_participantes(string_view id_to, vector<int> pre, vector<int> der, vector<Jugador> r);
     
     /** @brief Se asignan los participantes de la última edición al Torneo requerido
         \pre "id_to" es un string que representa el nombre de un torneo y "torn" contiene el vector de participantes 
-        \post Se ha asignado al Torneo "torn" el vector de participantes de la última edición
+        \post Se ha asignado al Torneo "torn" el vector de participantes de la última edición,
+        con un número de edición nuevo
+    */
+    void definir_ult_jugadores(string_view id_to, const Torneo& torn);
+
+    /** @brief Caducan los puntos de un participante de una edición
+        \pre <em>Cierto</em>
+        \post Si existe el Torneo "id_to" y su última edición es la número "ed", "id_p" es
+        el nombre de su participante i, "pt" los puntos que le quedaban por restar de esta
+        edición, que pasan a ser 0, 'c' la Categoria del Torneo y el resultado es cierto;
+        si no, el resultado es falso
+    */
+    bool caducar_puntos(string_view id_to, int ed, int i, string& id_p, int& pt, int& c);
+
+    /** @brief Se anulan los puntos de las últimas ediciones de todos los torneos
+        \pre <em>Cierto</em>
+        \post Ningún Torneo del conjunto tiene puntos por restar de su última edición
     */
-    void definir_ult_jugadores(string& id_to, Torneo& torn);
+    void anular_puntos();
+
+    /** @brief Se cambia el formato de los partidos de los torneos de una categoría
+        \pre <em>Cierto</em>
+        \post Todos los torneos del conjunto de la categoría "ca" tienen el formato 'f'
+    */
+    void definir_formato(int ca, Categoria::Formato f);
 
     
     // Consultores
@@ -77,7 +117,7 @@ public:
         \post El resultado indica si existe un Torneo con identificador id dentro 
         del conjunto de torneos
     */
-    bool existe_torneo(string& id);
+    bool existe_torneo(string_view id) const;
     
     /** @brief Consultor del número de toneos total del conjunto
         \pre <em>Cierto</em>
@@ -87,9 +127,23 @@ public:
     
     /** @brief Devuelve el Torneo con identificador id_to
         \pre Existe un Torneo en el conjunto con identificador id_to
-        \post El resultado es el torneo del conjunto con identificador id_to
+        \post El resultado es el torneo del conjunto con identificador id_to, sin copiarlo:
+        la referencia deja de ser válida al modificar el conjunto
+    */
+    const Torneo& consultar_torneo(string_view id_to) const;
+
+    /** @brief Consultor de la última edición de un Torneo
+        \pre Existe un Torneo en el conjunto con identificador id_to
+        \post El resultado es el número de la última edición finalizada del Torneo, o 0 si no hay
     */
-    Torneo consultar_torneo(string& id_to);
+    int consultar_edicion(string_view id_to) const;
+
+    /** @brief Devuelve los torneos iniciados que todavía no se han finalizado
+        \pre <em>Cierto</em>
+        \post "v" contiene los torneos del conjunto que se han iniciado y no se han
+        finalizado, crecientemente por nombre
+    */
+    void consultar_iniciados(vector<Torneo>& v) const;
     
     
     // Lectura y escritura
@@ -100,12 +154,23 @@ public:
         como identificador y un entero que representa la Categoria a la que pertenece.
     */
     void leer_torneos(map<int, Categoria>& map_cat);
+
+    /** @brief Operación de carga masiva de torneos desde un fichero
+        \pre <em>Cierto</em>
+        \post Si el fichero "fichero" no se ha podido abrir y leer, el resultado es NO_ABIERTO.
+        Si no contiene parejas formadas por un identificador y un entero que representa la
+        Categoria del torneo (le sobra una palabra al final), el resultado es MAL_FORMADO.
+        En los dos casos no se ha modificado el conjunto. Si no, se han añadido al conjunto
+        los torneos del fichero que no existían antes y cuya Categoria está en "map_cat"
+        (de los repetidos solo cuenta el primero con Categoria válida) y el resultado es CARGADO
+    */
+    Carga cargar_torneos(const string& fichero, map<int, Categoria>& map_cat);
     
     /** @brief Operación de escritura de los torneos del conjunto de torneos
         \pre <em>Cierto</em>
-        \post Se han escrito a través del canal estándar de salida el identificador 
+        \post Se han escrito a través del canal "os" el identificador 
         y la Categoria de los torneos del conjunto crecientemente (a partir del nombre)
     */
-    void listar_torneos();
+    void listar_torneos(ostream& os) const;
 };
 #endif
@@ -0,0 +1,175 @@
+/** @file EscritorBinario.cc
+    @brief Código de la clase EscritorBinario */
+
+#include "EscritorBinario.hh"
+#include "LectorComandos.hh"
+using namespace std;
+
+const char EscritorBinario::MAGIA[4] = {'\0', 'C', 'B', '1'};
+const unsigned char EscritorBinario::NOMBRE;
+
+// Copia 'n' palabras de "is" a "os", separadas por espacios y acabadas en un salto de linea
+static void copiar_palabras(istream& is, ostream& os, int n) {
+    string s;
+    for (int i = 0; i < n; ++i) {
+        is >> s;
+        if (i > 0) os << ' ';
+        os << s;
+    }
+    os << '\n';
+}
+
+
+// Funciones privadas
+
+void EscritorBinario::anadir_natural(unsigned int x) {
+    while (x >= 0x80) {
+        reg += char((x & 0x7f) | 0x80);
+        x >>= 7;
+    }
+    reg += char(x);
+}
+
+void EscritorBinario::anadir_entero(int x) {
+    anadir_natural((static_cast<unsigned int>(x) << 1) ^ static_cast<unsigned int>(x >> 31));
+}
+
+void EscritorBinario::anadir_nombre(const string& nom) {
+    pair<map<string, int>::iterator, bool> r = ident.insert(make_pair(nom, (int)ident.size()));
+    if (r.second) escribir_registro(char(NOMBRE) + nom);
+    anadir_natural(r.first->second);
+}
+
+void EscritorBinario::escribir_registro(const string& contenido) {
+    unsigned int n = contenido.size();
+    char lon[4] = {char(n & 0xff), char((n >> 8) & 0xff), char((n >> 16) & 0xff), char(n >> 24)};
+    os.write(lon, 4);
+    os.write(contenido.data(), n);
+}
+
+
+// Funciones publicas
+
+EscritorBinario::EscritorBinario(ostream& salida) : os(salida) {}
+
+void EscritorBinario::escribir(const Comando& com) {
+
+    // Los registros de los nombres nuevos salen mientras se forma el del comando,
+    // asi que quedan delante de el
+    reg.clear();
+    reg += char(com.codigo);
+    anadir_nombre(com.nombre);
+
+    switch (com.codigo) {
+
+        case Comando::NUEVO_JUGADOR:
+        case Comando::BAJA_JUGADOR:
+        case Comando::BAJA_TORNEO:
+        case Comando::CONSULTAR_JUGADOR:
+        case Comando::PERCENTIL_JUGADOR:
+        case Comando::HISTORIAL_JUGADOR:
+        case Comando::BUSCAR_JUGADOR:
+        case Comando::CARGAR_JUGADORES:
+        case Comando::CARGAR_TORNEOS:
+            anadir_nombre(com.id);
+            break;
+
+        case Comando::NUEVO_TORNEO:
+        case Comando::CUADRO_ARCHIVADO:
+            anadir_nombre(com.id);
+            anadir_entero(com.num);
+            break;
+
+        case Comando::FORMATO_CATEGORIA:
+            anadir_entero(com.num);
+            anadir_nombre(com.id);
+            break;
+
+        case Comando::CARA_A_CARA:
+            anadir_nombre(com.id);
+            anadir_nombre(com.id2);
+            break;
+
+        case Comando::PRONOSTICO_RANKING:
+            anadir_entero(com.num);
+            anadir_entero(com.semilla);
+            break;
+
+        case Comando::DEFINIR_CADUCIDAD:
+        case Comando::AVANZAR_SEMANAS:
+        case Comando::LISTAR_RANKING_CATEGORIA:
+        case Comando::CONTAR_PUNTOS:
+        case Comando::PUNTOS_CORTE:
+            anadir_entero(com.num);
+            break;
+
+        case Comando::INICIAR_TORNEO: {
+            anadir_nombre(com.id);
+            int n = com.posiciones.size();
+            anadir_natural(n);
+            for (int i = 0; i < n; ++i) anadir_entero(com.posiciones[i]);
+            break;
+        }
+
+        case Comando::FINALIZAR_TORNEO:
+        case Comando::SIMULAR_TORNEO: {
+            anadir_nombre(com.id);
+            const LoteResultados& lote = com.resultados;
+            int n = lote.numero_resultados();
+            anadir_natural(n);
+            string canonico;
+            for (int i = 0; i < n; ++i) {
+                const string& t = lote.texto(i);
+                if (t == "0") anadir_natural(0);
+                else {
+
+                    // Casi siempre el texto se puede rehacer a partir de los sets
+                    int s = lote.numero_sets(i);
+                    canonico.clear();
+                    for (int j = 0; j < s; ++j) {
+                        if (j > 0) canonico += ',';
+                        canonico += char('0' + lote.set(i, j).primer());
+                        canonico += '-';
+                        canonico += char('0' + lote.set(i, j).segon());
+                    }
+                    bool texto = canonico != t;
+                    anadir_natural(1 + 2*s + (texto ? 1 : 0));
+                    for (int j = 0; j < s; ++j) reg += char(lote.set(i, j).primer() << 4 | lote.set(i, j).segon());
+                    if (texto) {
+                        anadir_natural(t.size());
+                        reg += t;
+                    }
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+    escribir_registro(reg);
+}
+
+void EscritorBinario::convertir(istream& entrada, ostream& salida) {
+
+    // Datos iniciales: categorias y niveles, nombres de las categorias, puntos por
+    // nivel, torneos con su categoria y jugadores
+    int c, k, t, p;
+    entrada >> c >> k;
+    salida << c << ' ' << k << '\n';
+    copiar_palabras(entrada, salida, c);
+    for (int i = 0; i < c; ++i) copiar_palabras(entrada, salida, k);
+    entrada >> t;
+    salida << t << '\n';
+    for (int i = 0; i < t; ++i) copiar_palabras(entrada, salida, 2);
+    entrada >> p;
+    salida << p << '\n';
+    copiar_palabras(entrada, salida, p);
+    salida.write(MAGIA, 4);
+
+    LectorComandos lector(entrada);
+    EscritorBinario escritor(salida);
+    Comando com;
+    while (lector.leer(com)) escritor.escribir(com);
+    salida.flush();
+}
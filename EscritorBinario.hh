@@ -0,0 +1,106 @@
+/** @file EscritorBinario.hh
+    @brief Especificación de la clase EscritorBinario */
+
+#ifndef ESCRITOR_BINARIO_HH
+#define ESCRITOR_BINARIO_HH
+
+#include "Comando.hh"
+
+#ifndef NO_DIAGRAM
+#include <iostream>
+#include <map>
+#include <string>
+#endif
+using namespace std;
+
+/** @class EscritorBinario
+    @brief Escribe comandos en el formato binario que también acepta <em>LectorComandos</em>.
+    Una entrada binaria empieza por los datos iniciales del circuito en texto, igual que
+    una de texto, seguidos de MAGIA y de una secuencia de registros. Cada registro es su
+    longitud en 4 bytes (little endian) seguida de su contenido:
+    - Un registro que empieza por el byte NOMBRE define el siguiente identificador
+      (0, 1, 2...), que es el resto del registro: un nombre de comando, de jugador, de
+      torneo o de fichero. Se emite justo antes del primer comando que lo usa.
+    - Cualquier otro registro es un comando: su código (<em>Comando::Codigo</em>) en un
+      byte, el identificador con el que se escribió su nombre y sus datos. Los nombres
+      son identificadores y los enteros van en varint (los que pueden ser negativos, en
+      zigzag). Las posiciones de <em>iniciar_torneo</em> van precedidas de cuántas hay, y
+      los resultados de <em>finalizar_torneo</em> y <em>simular_torneo</em> de cuántos hay y,
+      cada uno, de una cabecera: 0 si es un árbol vacío y si no 1 + 2*s + t, donde s es
+      su número de sets y t vale 1 si su texto no es el que resulta de escribir los sets
+      como "a-b,c-d". Después van los s sets, cada uno en un byte (juegos del primero en
+      los 4 bits altos) y, si t es 1, la longitud del texto y el texto.
+    Un comando <em>fin</em> no se escribe: la entrada binaria acaba con el último registro.
+*/
+class EscritorBinario {
+
+private:
+
+    ostream& os;
+
+    /** @brief Identificador de cada nombre ya definido, con el nombre como clave */
+    map<string, int> ident;
+
+    /** @brief Contenido del registro que se está formando */
+    string reg;
+
+    /** @brief Función privada que añade un natural al registro
+        \pre <em>Cierto</em>
+        \post Se ha añadido 'x' al final de "reg" en varint
+    */
+    void anadir_natural(unsigned int x);
+
+    /** @brief Función privada que añade un entero al registro
+        \pre <em>Cierto</em>
+        \post Se ha añadido 'x' al final de "reg" en zigzag y varint
+    */
+    void anadir_entero(int x);
+
+    /** @brief Función privada que añade un nombre al registro
+        \pre <em>Cierto</em>
+        \post Se ha añadido a "reg" el identificador de "nom"; si no tenía, se le ha
+        asignado el siguiente y se ha escrito antes el registro que lo define
+    */
+    void anadir_nombre(const string& nom);
+
+    /** @brief Función privada que escribe un registro
+        \pre <em>Cierto</em>
+        \post Se ha escrito "contenido" precedido de su longitud a través del canal
+    */
+    void escribir_registro(const string& contenido);
+
+public:
+
+    /** @brief Marca que separa los datos iniciales en texto de los registros */
+    static const char MAGIA[4];
+
+    /** @brief Primer byte de los registros que definen un identificador */
+    static const unsigned char NOMBRE = 0xFF;
+
+    // Constructor
+
+    /** @brief Creador inicializado
+        \pre <em>Cierto</em>
+        \post El resultado es un escritor que escribe registros a través de "salida",
+        sin ningún identificador definido
+    */
+    EscritorBinario(ostream& salida);
+
+
+    // Escritura
+
+    /** @brief Se escribe un comando
+        \pre "com" lo ha leído un <em>LectorComandos</em>
+        \post Se ha escrito el registro de "com", precedido de los que definen los
+        nombres que usa por primera vez
+    */
+    void escribir(const Comando& com);
+
+    /** @brief Se convierte una entrada de texto al formato binario
+        \pre En "entrada" hay los datos iniciales del circuito y los comandos en texto
+        \post Se han escrito a través de "salida" los datos iniciales en texto, MAGIA y
+        los registros de los comandos leídos hasta <em>fin</em> o el final de la entrada
+    */
+    static void convertir(istream& entrada, ostream& salida);
+};
+#endif
@@ -0,0 +1,123 @@
+/** @file HistorialRanking.cc
+    @brief Código de la clase HistorialRanking */
+
+#include "HistorialRanking.hh"
+using namespace std;
+
+const int HistorialRanking::TAM_BLOQUE;
+
+// Bytes que ocupan como mucho las tres diferencias de una anotacion
+static const int MAX_ANOTACION = 15;
+
+// Codificacion de enteros
+
+// Los enteros con signo pequeños en valor absoluto pasan a naturales pequeños: 0, -1, 1, -2, ...
+static unsigned int zigzag(int x) {
+    return (static_cast<unsigned int>(x) << 1) ^ static_cast<unsigned int>(x >> 31);
+}
+
+static int deszigzag(unsigned int x) {
+    return static_cast<int>(x >> 1) ^ -static_cast<int>(x & 1);
+}
+
+// Escribe x en "p" con 7 bits por byte, con el bit alto indicando si siguen mas, y
+// devuelve los bytes escritos
+static int escribir_varint(unsigned char* p, unsigned int x) {
+    int n = 0;
+    while (x >= 0x80) {
+        p[n++] = (x & 0x7f) | 0x80;
+        x >>= 7;
+    }
+    p[n++] = x;
+    return n;
+}
+
+// Lee un varint a partir de p[i] y deja 'i' detras de el
+static unsigned int leer_varint(const unsigned char* p, int& i) {
+    unsigned int x = 0;
+    int d = 0;
+    while (p[i] & 0x80) {
+        x |= (unsigned int)(p[i++] & 0x7f) << d;
+        d += 7;
+    }
+    x |= (unsigned int)p[i++] << d;
+    return x;
+}
+
+
+// Funciones privadas
+
+void HistorialRanking::anotar(int s, int ev, int pos, int pts) {
+    unsigned char buf[MAX_ANOTACION];
+    int n = escribir_varint(buf, ev - series[s].evento);
+    n += escribir_varint(buf + n, zigzag(pos - series[s].posicion));
+    n += escribir_varint(buf + n, zigzag(pts - series[s].puntos));
+
+    // Una anotacion no se parte entre dos bloques: si no cabe, va entera en uno nuevo
+    int b = series[s].ultimo;
+    if (b == -1 or bloques[b].usados + n > TAM_BLOQUE) {
+        Bloque nuevo;
+        nuevo.usados = 0;
+        nuevo.sig = -1;
+        bloques.push_back(nuevo);
+        int nb = bloques.size() - 1;
+        if (b == -1) series[s].primero = nb;
+        else bloques[b].sig = nb;
+        series[s].ultimo = b = nb;
+    }
+    Bloque& bl = bloques[b];
+    for (int i = 0; i < n; ++i) bl.datos[bl.usados + i] = buf[i];
+    bl.usados += n;
+
+    series[s].evento = ev;
+    series[s].posicion = pos;
+    series[s].puntos = pts;
+}
+
+
+// Funciones publicas
+
+HistorialRanking::HistorialRanking() {}
+
+void HistorialRanking::registrar(const ConjuntoJugadores& jugadores, const string& id_to, bool final) {
+    torneo_evento.push_back(id_to);
+    final_evento.push_back(final);
+    int ev = torneo_evento.size();
+
+    // La posicion de cada jugador es su sitio en el ranking, que esta actualizado
+    int n = jugadores.numero_jugadores();
+    for (int i = 1; i <= n; ++i) {
+        const Jugador& jug = jugadores.consultar_jugador_rank(i);
+        pair<map<string, int>::iterator, bool> r = num_jugador.insert(make_pair(jug.consultar_nombre(), (int)series.size()));
+        if (r.second) {
+            Serie s = {-1, -1, 0, 0, 0};
+            series.push_back(s);
+        }
+        const Serie& s = series[r.first->second];
+        if (r.second or s.posicion != i or s.puntos != jug.consultar_puntos())
+            anotar(r.first->second, ev, i, jug.consultar_puntos());
+    }
+}
+
+bool HistorialRanking::tiene_historial(const string& id_p) const {
+    return num_jugador.find(id_p) != num_jugador.end();
+}
+
+void HistorialRanking::escribir_trayectoria(const string& id_p, ostream& os) const {
+    map<string, int>::const_iterator it = num_jugador.find(id_p);
+    if (it == num_jugador.end()) return;
+
+    // Se deshacen las diferencias recorriendo la cadena de bloques del jugador
+    int ev = 0, pos = 0, pts = 0;
+    for (int b = series[it->second].primero; b != -1; b = bloques[b].sig) {
+        const Bloque& bl = bloques[b];
+        int i = 0;
+        while (i < bl.usados) {
+            ev += leer_varint(bl.datos, i);
+            pos += deszigzag(leer_varint(bl.datos, i));
+            pts += deszigzag(leer_varint(bl.datos, i));
+            os << ev << ' ' << (final_evento[ev-1] ? "ft" : "bt") << ' ' << torneo_evento[ev-1]
+               << ' ' << pos << ' ' << pts << endl;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/** @file HistorialRanking.hh
+    @brief Especificación de la clase HistorialRanking */
+
+#ifndef HISTORIAL_RANKING_HH
+#define HISTORIAL_RANKING_HH
+
+#include "ConjuntoJugadores.hh"
+
+#ifndef NO_DIAGRAM
+#include <map>
+#include <string>
+#include <vector>
+#endif
+using namespace std;
+
+/** @class HistorialRanking
+    @brief Evolución de la posición y los puntos de cada jugador en el ranking.
+    Cada vez que se finaliza o se da de baja un torneo se registra un evento, en el que
+    solo se anotan los jugadores cuya posición o cuyos puntos han cambiado desde su
+    anotación anterior. Cada anotación se guarda como tres diferencias con la anterior
+    del mismo jugador (de número de evento, de posición y de puntos) codificadas en
+    varint, las dos últimas en zigzag porque pueden ser negativas. Las anotaciones de
+    cada jugador van en una cadena de bloques de tamaño fijo en la que solo se escribe
+    al final, así que su trayectoria se recorre sin mirar las de los demás.
+*/
+class HistorialRanking {
+
+private:
+
+    /** @brief Bytes de anotaciones de un bloque */
+    static const int TAM_BLOQUE = 52;
+
+    /** @brief Bloque de anotaciones de un jugador */
+    struct Bloque {
+        unsigned char datos[TAM_BLOQUE];
+        int usados;
+
+        /** @brief Siguiente bloque del mismo jugador, o -1 si es el último */
+        int sig;
+    };
+
+    /** @brief Cadena de bloques de un jugador y su última anotación */
+    struct Serie {
+        int primero;
+        int ultimo;
+        int evento;
+        int posicion;
+        int puntos;
+    };
+
+    /** @brief Número de la serie de cada jugador que se ha anotado, con su nombre como clave */
+    map<string, int> num_jugador;
+
+    vector<Serie> series;
+    vector<Bloque> bloques;
+
+    /** @brief Torneo de cada evento y si se finalizó (cierto) o se dio de baja (falso) */
+    vector<string> torneo_evento;
+    vector<bool> final_evento;
+
+    /** @brief Función privada que añade una anotación a una serie
+        \pre 's' es una serie del historial y "ev" es posterior a su última anotación
+        \post Se ha añadido al final de la cadena de 's' la anotación (ev, pos, pts)
+    */
+    void anotar(int s, int ev, int pos, int pts);
+
+public:
+
+    // Constructor
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un historial sin eventos
+    */
+    HistorialRanking();
+
+
+    // Modificador
+
+    /** @brief Se registra un evento del ranking
+        \pre El ranking de "jugadores" está actualizado después de finalizar ("final" cierto)
+        o dar de baja ("final" falso) el torneo "id_to"
+        \post Se ha añadido un evento en el que se han anotado la posición y los puntos de
+        los jugadores de "jugadores" que han cambiado desde su última anotación
+    */
+    void registrar(const ConjuntoJugadores& jugadores, const string& id_to, bool final);
+
+
+    // Consultor
+
+    /** @brief Consulta si un jugador tiene alguna anotación
+        \pre <em>Cierto</em>
+        \post El resultado indica si se ha anotado alguna vez al jugador "id_p"
+    */
+    bool tiene_historial(const string& id_p) const;
+
+
+    // Escritura
+
+    /** @brief Operación de escritura de la trayectoria de un jugador
+        \pre <em>Cierto</em>
+        \post Se ha escrito a través del canal "os" una línea por cada anotación del jugador
+        "id_p", en orden, con el número de evento, "ft" o "bt", el torneo, la posición y los
+        puntos. El coste es proporcional al número de anotaciones del jugador
+    */
+    void escribir_trayectoria(const string& id_p, ostream& os) const;
+};
+#endif
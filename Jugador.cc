@@ -16,10 +16,11 @@ Jugador::Jugador() {
     juegos_ganados = 0;
     juegos_perdidos = 0;
     ptos_torneo_actual = 0;
+    elo = ELO_INICIAL;
 }
 
-Jugador::Jugador(string& id_j) {
-    id = id_j;
+Jugador::Jugador(string id_j) {
+    id = move(id_j);
     pos_ranking = 0;
     ptos = 0;
     torneos_disputados = 0;
@@ -30,10 +31,11 @@ Jugador::Jugador(string& id_j) {
     juegos_ganados = 0;
     juegos_perdidos = 0;
     ptos_torneo_actual = 0;
+    elo = ELO_INICIAL;
 }
 
-Jugador::Jugador(string& id_j, int i) {
-    id = id_j;
+Jugador::Jugador(string id_j, int i) {
+    id = move(id_j);
     pos_ranking = i;
     ptos = 0;
     torneos_disputados = 0;
@@ -44,6 +46,7 @@ Jugador::Jugador(string& id_j, int i) {
     juegos_ganados = 0;
     juegos_perdidos = 0;
     ptos_torneo_actual = 0;
+    elo = ELO_INICIAL;
 }
 
 void Jugador::sum_ptos(int x) {
@@ -57,6 +60,27 @@ void Jugador::rest(int x) {
     if (ptos < 0) ptos = 0;
 }
 
+void Jugador::anular_ptos_torneo() {
+    ptos_torneo_actual = 0;
+}
+
+void Jugador::anular_ptos() {
+    ptos = 0;
+    ptos_cat.clear();
+}
+
+void Jugador::sum_ptos_cat(int c, int x) {
+    if ((int)ptos_cat.size() < c) ptos_cat.resize(c, 0);
+    ptos_cat[c-1] += x;
+}
+
+void Jugador::rest_cat(int c, int x) {
+    if (c <= (int)ptos_cat.size()) {
+        ptos_cat[c-1] -= x;
+        if (ptos_cat[c-1] < 0) ptos_cat[c-1] = 0;
+    }
+}
+
 void Jugador::modificar_posicion(int x) {
     pos_ranking = x;
 }
@@ -77,6 +101,10 @@ void Jugador::restar_set() {
     ++sets_perdidos;
 }
 
+void Jugador::sumar_elo(double x) {
+    elo += x;
+}
+
 void Jugador::sumar_partido() {
     ++partidos_ganados;
 }
@@ -85,7 +113,7 @@ void Jugador::restar_partido() {
     ++partidos_perdidos;
 }
 
-string Jugador::consultar_nombre() const {
+const string& Jugador::consultar_nombre() const {
     return id;
 }
 
@@ -101,16 +129,33 @@ int Jugador::consultar_ptos_rest() const{
     return ptos_torneo_actual;
 }
 
-void Jugador::listar_jugador() const{
-    cout << id << ' ';
-    cout << "Rk:" << pos_ranking << ' ';
-    cout << "Ps:" << ptos << ' ';
-    cout << "Ts:" << torneos_disputados << ' ';
-    cout << "WM:" << partidos_ganados << ' ';
-    cout << "LM:" << partidos_perdidos << ' ';
-    cout << "WS:" << sets_ganados << ' ';
-    cout << "LS:" << sets_perdidos << ' ';
-    cout << "WG:" << juegos_ganados << ' ';
-    cout << "LG:" << juegos_perdidos << endl;
+int Jugador::consultar_ptos_cat(int c) const{
+    if (c <= (int)ptos_cat.size()) return ptos_cat[c-1];
+    else return 0;
+}
+
+int Jugador::consultar_partidos_ganados() const{
+    return partidos_ganados;
+}
+
+int Jugador::consultar_partidos_perdidos() const{
+    return partidos_perdidos;
+}
+
+double Jugador::consultar_elo() const{
+    return elo;
+}
+
+void Jugador::listar_jugador(ostream& os) const{
+    os << id << ' ';
+    os << "Rk:" << pos_ranking << ' ';
+    os << "Ps:" << ptos << ' ';
+    os << "Ts:" << torneos_disputados << ' ';
+    os << "WM:" << partidos_ganados << ' ';
+    os << "LM:" << partidos_perdidos << ' ';
+    os << "WS:" << sets_ganados << ' ';
+    os << "LS:" << sets_perdidos << ' ';
+    os << "WG:" << juegos_ganados << ' ';
+    os << "LG:" << juegos_perdidos << endl;
 }
 
@@ -7,6 +7,7 @@
 #ifndef NO_DIAGRAM 
 #include <iostream>
 #include <string>
+#include <vector>
 #endif
 using namespace std;
 
@@ -16,7 +17,10 @@ using namespace std;
     y una serie de atributos en forma de enteros que representan las estadísticas 
     de cada jugador: posición en el ranking, puntos actuales, torneos disputados,
     partidos ganados y perdidos, sets ganados y perdidos, juegos ganados y perdidos, 
-    y los puntos ganados en la edición actual o en la última edición del torneo. */
+    y los puntos ganados en la edición actual o en la última edición del torneo.
+    También guarda, de los puntos actuales, los que ha conseguido en torneos de cada categoría,
+    y su rating de tipo Elo, que mide su fuerza según los rivales a los que ha ganado y
+    con los que ha perdido. */
 class Jugador {
 
 private:
@@ -32,8 +36,18 @@ private:
     int juegos_ganados;
     int juegos_perdidos;
     int ptos_torneo_actual;
+
+    /** @brief Puntos actuales conseguidos en torneos de cada categoría: ptos_cat[c-1] son
+        los de la categoría c (las que no tienen elemento tienen 0) */
+    vector<int> ptos_cat;
+
+    /** @brief Rating de tipo Elo; un jugador nuevo empieza con ELO_INICIAL */
+    double elo;
     
 public:
+
+    /** @brief Rating de un jugador que todavía no ha disputado ningún partido */
+    static const int ELO_INICIAL = 1500;
     
     // Constructores
     
@@ -50,14 +64,14 @@ public:
         \post El resultado es un Jugador inicializado con identificador = id_j 
         y el resto de los atributos inicializados a 0
     */
-    Jugador(string& id_j);
+    Jugador(string id_j);
     
     /** @brief Creador inicializado 
         Se genera un Jugador inicializado con nombre y posicion en el ranking
         \pre <em>Cierto</em>
         \post El resultado es un jugador inicializado con identificador = id_j
         y posicion en el ranking = i    */
-    Jugador(string& id_j, int i);
+    Jugador(string id_j, int i);
     
     
     // Modificadores
@@ -76,6 +90,31 @@ public:
         los puntos pasados como parametro
     */
     void rest(int x);
+
+    /** @brief Se anulan los puntos del Jugador en el último torneo disputado
+        \pre Jugador inicializado
+        \post Los puntos del Jugador en el torneo actual o el último disputado son 0
+    */
+    void anular_ptos_torneo();
+
+    /** @brief Se anulan todos los puntos del Jugador
+        \pre Jugador inicializado
+        \post Los puntos del Jugador, en total y en cada categoría, son 0
+    */
+    void anular_ptos();
+
+    /** @brief Se suman puntos al Jugador en una categoría
+        \pre Jugador inicializado y c >= 1
+        \post Se han sumado 'x' puntos a los que tiene el Jugador en la categoría c
+    */
+    void sum_ptos_cat(int c, int x);
+
+    /** @brief Se restan puntos al Jugador en una categoría
+        \pre Jugador inicializado y c >= 1
+        \post Se han restado 'x' puntos a los que tiene el Jugador en la categoría c,
+        sin bajar de 0
+    */
+    void rest_cat(int c, int x);
     
     /** @brief Se modifica la posicion en el ranking del Jugador 
         \pre 1 <= x <= numero de jugadores
@@ -122,6 +161,12 @@ public:
         \post Se ha sumado al Jugador un partido perdido
     */
     void restar_partido();
+
+    /** @brief Se suma al Jugador una variación de su rating
+        \pre Jugador inicializado
+        \post Se ha sumado 'x' (que puede ser negativo) al rating del Jugador
+    */
+    void sumar_elo(double x);
     
 
     // Consultores
@@ -130,7 +175,7 @@ public:
         \pre Jugador inicializado
         \post Se ha devuelto el nombre de Jugador en forma de string
     */
-    string consultar_nombre() const;
+    const string& consultar_nombre() const;
     
     /** @brief Consultor de la posicion en el ranking del Jugador
         \pre Jugador inicializado
@@ -151,15 +196,39 @@ public:
         o el último disputado
     */
     int consultar_ptos_rest() const;
+
+    /** @brief Consultor de los puntos del Jugador en una categoría
+        \pre Jugador inicializado y c >= 1
+        \post Se han devuelto los puntos actuales del Jugador conseguidos en torneos de la categoría c
+    */
+    int consultar_ptos_cat(int c) const;
+
+    /** @brief Consultor de los partidos ganados por el Jugador
+        \pre Jugador inicializado
+        \post Se han devuelto los partidos ganados por el Jugador en el circuito
+    */
+    int consultar_partidos_ganados() const;
+
+    /** @brief Consultor de los partidos perdidos por el Jugador
+        \pre Jugador inicializado
+        \post Se han devuelto los partidos perdidos por el Jugador en el circuito
+    */
+    int consultar_partidos_perdidos() const;
+
+    /** @brief Consultor del rating del Jugador
+        \pre Jugador inicializado
+        \post Se ha devuelto el rating de tipo Elo del Jugador
+    */
+    double consultar_elo() const;
     
     
     // Lectura y escritura
     
     /** @brief Se lista un Jugador con identificador
         \pre Jugador inicializado
-        \post Se ha escrito a traves del canal estándar de salida su nombre, posicion 
+        \post Se ha escrito a traves del canal "os" su nombre, posicion 
         en el ranking, puntos, y el resto de estadisticas del Jugador en el circuito
     */
-    void listar_jugador() const;
+    void listar_jugador(ostream& os) const;
 };
 #endif
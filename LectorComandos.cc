@@ -0,0 +1,311 @@
+/** @file LectorComandos.cc
+    @brief Código de la clase LectorComandos */
+
+#include "LectorComandos.hh"
+#include "EscritorBinario.hh"
+#ifndef NO_DIAGRAM
+#include <algorithm>
+#endif
+using namespace std;
+
+// Lectura de los datos de un registro binario a partir de r[i], dejando 'i' detras.
+// Si el registro se acaba antes de tiempo, lo que falta se lee como 0
+
+static unsigned int leer_natural(const vector<unsigned char>& r, int& i) {
+    unsigned int x = 0;
+    int d = 0;
+    bool sigue = true;
+    while (sigue and i < (int)r.size()) {
+        x |= (unsigned int)(r[i] & 0x7f) << d;
+        sigue = r[i++] & 0x80;
+        d += 7;
+    }
+    return x;
+}
+
+static int leer_entero(const vector<unsigned char>& r, int& i) {
+    unsigned int x = leer_natural(r, i);
+    return static_cast<int>(x >> 1) ^ -static_cast<int>(x & 1);
+}
+
+static const string& leer_nombre(const vector<unsigned char>& r, int& i, const vector<string>& nombres) {
+    static const string vacio;
+    unsigned int h = leer_natural(r, i);
+    return h < nombres.size() ? nombres[h] : vacio;
+}
+
+
+// Funciones privadas
+
+Comando::Codigo LectorComandos::codigo(const string& nom) {
+    if (nom == "nuevo_jugador" or nom == "nj") return Comando::NUEVO_JUGADOR;
+    if (nom == "nuevo_torneo" or nom == "nt") return Comando::NUEVO_TORNEO;
+    if (nom == "baja_jugador" or nom == "bj") return Comando::BAJA_JUGADOR;
+    if (nom == "baja_torneo" or nom == "bt") return Comando::BAJA_TORNEO;
+    if (nom == "iniciar_torneo" or nom == "it") return Comando::INICIAR_TORNEO;
+    if (nom == "finalizar_torneo" or nom == "ft") return Comando::FINALIZAR_TORNEO;
+    if (nom == "listar_ranking" or nom == "lr") return Comando::LISTAR_RANKING;
+    if (nom == "listar_jugadores" or nom == "lj") return Comando::LISTAR_JUGADORES;
+    if (nom == "consultar_jugador" or nom == "cj") return Comando::CONSULTAR_JUGADOR;
+    if (nom == "listar_torneos" or nom == "lt") return Comando::LISTAR_TORNEOS;
+    if (nom == "listar_categorias" or nom == "lc") return Comando::LISTAR_CATEGORIAS;
+    if (nom == "cargar_jugadores" or nom == "cgj") return Comando::CARGAR_JUGADORES;
+    if (nom == "cargar_torneos" or nom == "cgt") return Comando::CARGAR_TORNEOS;
+    if (nom == "pronostico_ranking" or nom == "pr") return Comando::PRONOSTICO_RANKING;
+    if (nom == "simular_torneo" or nom == "st") return Comando::SIMULAR_TORNEO;
+    if (nom == "definir_caducidad" or nom == "dc") return Comando::DEFINIR_CADUCIDAD;
+    if (nom == "avanzar_semanas" or nom == "as") return Comando::AVANZAR_SEMANAS;
+    if (nom == "cara_a_cara" or nom == "cc") return Comando::CARA_A_CARA;
+    if (nom == "listar_ranking_categoria" or nom == "lrc") return Comando::LISTAR_RANKING_CATEGORIA;
+    if (nom == "contar_puntos" or nom == "cpt") return Comando::CONTAR_PUNTOS;
+    if (nom == "percentil_jugador" or nom == "pj") return Comando::PERCENTIL_JUGADOR;
+    if (nom == "puntos_corte" or nom == "pc") return Comando::PUNTOS_CORTE;
+    if (nom == "reiniciar_temporada" or nom == "rt") return Comando::REINICIAR_TEMPORADA;
+    if (nom == "historial_jugador" or nom == "hj") return Comando::HISTORIAL_JUGADOR;
+    if (nom == "inicio_lote" or nom == "il") return Comando::INICIO_LOTE;
+    if (nom == "fin_lote" or nom == "fl") return Comando::FIN_LOTE;
+    if (nom == "formato_categoria" or nom == "fc") return Comando::FORMATO_CATEGORIA;
+    if (nom == "cuadro_archivado" or nom == "ca") return Comando::CUADRO_ARCHIVADO;
+    if (nom == "ranking_elo" or nom == "re") return Comando::RANKING_ELO;
+    if (nom == "buscar_jugador" or nom == "bsj") return Comando::BUSCAR_JUGADOR;
+    return Comando::DESCONOCIDO;
+}
+
+
+bool LectorComandos::leer_registro() {
+    unsigned char lon[4];
+    if (not is.read(reinterpret_cast<char*>(lon), 4)) return false;
+    unsigned int n = lon[0] | lon[1] << 8 | lon[2] << 16 | (unsigned int)lon[3] << 24;
+    reg.resize(n);
+    return n == 0 or is.read(reinterpret_cast<char*>(reg.data()), n);
+}
+
+bool LectorComandos::leer_binario(Comando& com) {
+
+    // Antes del comando pueden venir las definiciones de los nombres que usa
+    bool hay = leer_registro();
+    while (hay and not reg.empty() and reg[0] == EscritorBinario::NOMBRE) {
+        nombres.push_back(string(reg.begin() + 1, reg.end()));
+        hay = leer_registro();
+    }
+    if (not hay or reg.empty()) return false;
+
+    int i = 1;
+    com.codigo = Comando::Codigo(reg[0]);
+    com.nombre = leer_nombre(reg, i, nombres);
+    com.id.clear();
+    com.id2.clear();
+    com.num = 0;
+    com.semilla = 0;
+    com.secuencia = 0;
+    com.posiciones.clear();
+
+    switch (com.codigo) {
+
+        case Comando::NUEVO_JUGADOR:
+        case Comando::BAJA_JUGADOR:
+        case Comando::BAJA_TORNEO:
+        case Comando::CONSULTAR_JUGADOR:
+        case Comando::PERCENTIL_JUGADOR:
+        case Comando::HISTORIAL_JUGADOR:
+        case Comando::BUSCAR_JUGADOR:
+        case Comando::CARGAR_JUGADORES:
+        case Comando::CARGAR_TORNEOS:
+            com.id = leer_nombre(reg, i, nombres);
+            break;
+
+        case Comando::NUEVO_TORNEO:
+        case Comando::CUADRO_ARCHIVADO:
+            com.id = leer_nombre(reg, i, nombres);
+            com.num = leer_entero(reg, i);
+            break;
+
+        case Comando::FORMATO_CATEGORIA:
+            com.num = leer_entero(reg, i);
+            com.id = leer_nombre(reg, i, nombres);
+            break;
+
+        case Comando::CARA_A_CARA:
+            com.id = leer_nombre(reg, i, nombres);
+            com.id2 = leer_nombre(reg, i, nombres);
+            break;
+
+        case Comando::PRONOSTICO_RANKING:
+            com.num = leer_entero(reg, i);
+            com.semilla = leer_entero(reg, i);
+            break;
+
+        case Comando::DEFINIR_CADUCIDAD:
+        case Comando::AVANZAR_SEMANAS:
+        case Comando::LISTAR_RANKING_CATEGORIA:
+        case Comando::CONTAR_PUNTOS:
+        case Comando::PUNTOS_CORTE:
+            com.num = leer_entero(reg, i);
+            break;
+
+        case Comando::INICIAR_TORNEO: {
+            com.id = leer_nombre(reg, i, nombres);
+            int n = leer_natural(reg, i);
+            com.posiciones.resize(n);
+            for (int j = 0; j < n; ++j) com.posiciones[j] = leer_entero(reg, i);
+            break;
+        }
+
+        case Comando::FINALIZAR_TORNEO:
+        case Comando::SIMULAR_TORNEO: {
+
+            // Los sets ya vienen separados: solo hay que rehacer el texto de cada resultado
+            // (o copiarlo, si no es el normal) y no hace falta decodificar el lote
+            com.id = leer_nombre(reg, i, nombres);
+            int n = leer_natural(reg, i);
+            res.resize(n);
+            sets.clear();
+            inicio.resize(n+1);
+            for (int j = 0; j < n; ++j) {
+                inicio[j] = sets.size();
+                string& t = res[j];
+                t.clear();
+                unsigned int cab = leer_natural(reg, i);
+                if (cab == 0) t = "0";
+                else {
+                    int s = (cab - 1)/2;
+                    bool texto = (cab - 1)%2;
+                    for (int k = 0; k < s and i < (int)reg.size(); ++k) {
+                        int a = reg[i] >> 4, b = reg[i] & 0xf;
+                        ++i;
+                        sets.push_back(ParInt(a, b));
+                        if (not texto) {
+                            if (k > 0) t += ',';
+                            t += char('0' + a);
+                            t += '-';
+                            t += char('0' + b);
+                        }
+                    }
+                    if (texto) {
+                        int m = leer_natural(reg, i);
+                        if (m > (int)reg.size() - i) m = reg.size() - i;
+                        t.assign(reg.begin() + i, reg.begin() + i + m);
+                        i += m;
+                    }
+                }
+            }
+            inicio[n] = sets.size();
+            com.resultados.asignar(res, sets, inicio);
+            break;
+        }
+
+        default:
+            break;
+    }
+    return true;
+}
+
+
+// Funciones publicas
+
+LectorComandos::LectorComandos(istream& entrada) : is(entrada) {
+    secuenciado = false;
+    decidido = false;
+    binario = false;
+}
+
+LectorComandos::LectorComandos(istream& entrada, bool secuenciado) : is(entrada) {
+    this->secuenciado = secuenciado;
+    decidido = false;
+    binario = false;
+}
+
+bool LectorComandos::leer(Comando& com) {
+
+    // La primera vez se mira si la entrada empieza por la marca del formato binario
+    if (not decidido) {
+        decidido = true;
+        if ((is >> ws) and is.peek() == EscritorBinario::MAGIA[0]) {
+            char m[4];
+            binario = is.read(m, 4) and equal(m, m + 4, EscritorBinario::MAGIA);
+            if (not binario) return false;
+        }
+    }
+    if (binario) return not secuenciado and leer_binario(com);
+
+    com.secuencia = 0;
+    if (secuenciado and not (is >> com.secuencia)) return false;
+    if (not (is >> com.nombre) or com.nombre == "fin") return false;
+
+    com.codigo = codigo(com.nombre);
+    com.id.clear();
+    com.id2.clear();
+    com.num = 0;
+    com.semilla = 0;
+    com.posiciones.clear();
+
+    switch (com.codigo) {
+
+        case Comando::NUEVO_JUGADOR:
+        case Comando::BAJA_JUGADOR:
+        case Comando::BAJA_TORNEO:
+        case Comando::CONSULTAR_JUGADOR:
+        case Comando::PERCENTIL_JUGADOR:
+        case Comando::HISTORIAL_JUGADOR:
+        case Comando::BUSCAR_JUGADOR:
+        case Comando::CARGAR_JUGADORES:
+        case Comando::CARGAR_TORNEOS:
+            is >> com.id;
+            break;
+
+        case Comando::NUEVO_TORNEO:
+        case Comando::CUADRO_ARCHIVADO:
+            is >> com.id >> com.num;
+            break;
+
+        case Comando::FORMATO_CATEGORIA:
+            is >> com.num >> com.id;
+            break;
+
+        case Comando::CARA_A_CARA:
+            is >> com.id >> com.id2;
+            break;
+
+        case Comando::PRONOSTICO_RANKING:
+            is >> com.num >> com.semilla;
+            break;
+
+        case Comando::DEFINIR_CADUCIDAD:
+        case Comando::AVANZAR_SEMANAS:
+        case Comando::LISTAR_RANKING_CATEGORIA:
+        case Comando::CONTAR_PUNTOS:
+        case Comando::PUNTOS_CORTE:
+            is >> com.num;
+            break;
+
+        case Comando::INICIAR_TORNEO: {
+            int n = 0;
+            is >> com.id >> n;
+            com.posiciones.resize(n);
+            for (int i = 0; i < n; ++i) is >> com.posiciones[i];
+            break;
+        }
+
+        case Comando::FINALIZAR_TORNEO:
+        case Comando::SIMULAR_TORNEO: {
+
+            // El arbol de resultados se lee en preorden: cada resultado deja dos
+            // subarboles pendientes y cada "0" cierra uno. Los sets de todos los
+            // resultados se obtienen de una vez al acabar de leer el arbol
+            is >> com.id;
+            int pendientes = 1;
+            string x;
+            while (pendientes > 0 and is >> x) {
+                res.push_back(x);
+                if (x == "0") --pendientes;
+                else ++pendientes;
+            }
+            com.resultados.decodificar(res);
+            break;
+        }
+
+        default:
+            break;
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+/** @file LectorComandos.hh
+    @brief Especificación de la clase LectorComandos */
+
+#ifndef LECTOR_COMANDOS_HH
+#define LECTOR_COMANDOS_HH
+
+#include "Comando.hh"
+
+#ifndef NO_DIAGRAM
+#include <iostream>
+#endif
+
+/** @class LectorComandos
+    @brief Lee comandos de un canal de entrada y los convierte en registros <em>Comando</em>.
+    La lectura no depende del estado del circuito: <em>iniciar_torneo</em>,
+    <em>finalizar_torneo</em> y <em>simular_torneo</em> siempre van seguidos de sus
+    participantes o de su árbol de resultados, aunque el torneo no exista.
+    Los comandos pueden estar en texto o en el formato binario de <em>EscritorBinario</em>;
+    se sabe cuál es al leer el primero, según si empiezan por su marca.
+    En una entrada secuenciada cada comando va precedido de su número de secuencia, y
+    tiene que ser de texto.
+*/
+class LectorComandos {
+
+private:
+
+    istream& is;
+
+    /** @brief Buffer de los resultados de <em>finalizar_torneo</em>, que se reutiliza entre comandos */
+    vector<string> res;
+
+    /** @brief Indica si cada comando va precedido de su número de secuencia */
+    bool secuenciado;
+
+    /** @brief Indica si ya se sabe el formato de la entrada y si es binario */
+    bool decidido;
+    bool binario;
+
+    /** @brief Nombres definidos en la entrada binaria, por identificador */
+    vector<string> nombres;
+
+    /** @brief Contenido del último registro binario leído */
+    vector<unsigned char> reg;
+
+    /** @brief Buffers de los sets de los resultados binarios, que se reutilizan entre comandos */
+    vector<ParInt> sets;
+    vector<int> inicio;
+
+    /** @brief Función privada que lee un registro binario
+        \pre La entrada es binaria y ya se ha pasado su marca
+        \post Si quedaba un registro completo, está en "reg" y el resultado es cierto;
+        si no, el resultado es falso
+    */
+    bool leer_registro();
+
+    /** @brief Función privada que lee el siguiente comando binario
+        \pre Las mismas que <em>leer_registro</em>
+        \post Si quedaba algún comando, "com" contiene el comando con todos sus datos,
+        se han guardado en "nombres" los nombres definidos antes de él y el resultado es
+        cierto; si no, el resultado es falso
+    */
+    bool leer_binario(Comando& com);
+
+    /** @brief Función privada que traduce el nombre de un comando a su código
+        \pre <em>Cierto</em>
+        \post El resultado es el código del comando "nom" (completo o abreviado),
+        o DESCONOCIDO si no es ningún comando
+    */
+    static Comando::Codigo codigo(const string& nom);
+
+public:
+
+    // Constructor
+
+    /** @brief Creador inicializado
+        \pre <em>Cierto</em>
+        \post El resultado es un lector de comandos del canal "entrada"
+    */
+    LectorComandos(istream& entrada);
+
+    /** @brief Creador inicializado
+        \pre <em>Cierto</em>
+        \post El resultado es un lector de comandos del canal "entrada", en el que cada
+        comando va precedido de su número de secuencia si "secuenciado"
+    */
+    LectorComandos(istream& entrada, bool secuenciado);
+
+
+    // Lectura
+
+    /** @brief Lee el siguiente comando
+        \pre <em>Cierto</em>
+        \post Si el siguiente comando del canal no es <em>fin</em> ni se ha acabado
+        la entrada, "com" contiene el comando con todos sus datos y el resultado
+        es cierto; si no, el resultado es falso. En una entrada secuenciada también se
+        acaba si falta el número de secuencia o si la entrada es binaria
+    */
+    bool leer(Comando& com);
+};
+#endif
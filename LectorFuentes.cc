@@ -0,0 +1,86 @@
+/** @file LectorFuentes.cc
+    @brief Código de la clase LectorFuentes */
+
+#include "LectorFuentes.hh"
+#ifndef NO_DIAGRAM
+#include <fstream>
+#include <iostream>
+#endif
+using namespace std;
+
+
+// Funciones privadas
+
+void LectorFuentes::leer_fuente(int f) {
+
+    // Se abre aqui y no al crear el lector porque abrir un FIFO espera a que haya alguien
+    // escribiendo, y cada fuente no tiene por que esperar a las demas
+    ifstream fs(rutas[f]);
+    Leido x;
+    x.fin = false;
+    x.abierta = bool(fs);
+    if (fs) {
+        LectorComandos lector(fs, true);
+        while (lector.leer(x.com)) colas[f]->encolar(x);
+    }
+    x.fin = true;
+    colas[f]->encolar(x);
+    colas[f]->cerrar();
+}
+
+void LectorFuentes::desencolar(int f) {
+    Leido x;
+    while (not hay_siguiente[f] and not acabada[f]) {
+        if (not colas[f]->desencolar(x) or x.fin) {
+            acabada[f] = true;
+            if (not x.abierta) cerr << "error: no se puede abrir la fuente " << rutas[f] << endl;
+        }
+        else if (hay_ultima[f] and x.com.secuencia <= ultima[f])
+            cerr << "error: secuencia " << x.com.secuencia << " no creciente en la fuente "
+                 << rutas[f] << endl;
+        else {
+            ultima[f] = x.com.secuencia;
+            hay_ultima[f] = true;
+            siguiente[f] = move(x.com);
+            hay_siguiente[f] = true;
+        }
+    }
+}
+
+
+// Funciones publicas
+
+LectorFuentes::LectorFuentes(const vector<string>& rutas)
+    : rutas(rutas), siguiente(rutas.size()), hay_siguiente(rutas.size(), false),
+      acabada(rutas.size(), false), ultima(rutas.size(), 0), hay_ultima(rutas.size(), false) {
+    for (int f = 0; f < (int)rutas.size(); ++f)
+        colas.push_back(unique_ptr< ColaSPSC<Leido> >(new ColaSPSC<Leido>(TAM_COLA)));
+    for (int f = 0; f < (int)rutas.size(); ++f)
+        hilos.push_back(thread(&LectorFuentes::leer_fuente, this, f));
+}
+
+LectorFuentes::~LectorFuentes() {
+
+    // Si no se ha leido todo, los hilos pueden estar esperando a que haya sitio en su cola
+    Leido x;
+    for (int f = 0; f < (int)hilos.size(); ++f) {
+        while (colas[f]->desencolar(x));
+        hilos[f].join();
+    }
+}
+
+bool LectorFuentes::leer(Comando& com) {
+
+    // Solo se espera a las fuentes sin comando pendiente: hasta que todas las que no se
+    // han acabado tienen uno no se sabe cual es el siguiente, y las demas no ocupan mas
+    // que su cola
+    int m = -1;
+    for (int f = 0; f < (int)rutas.size(); ++f) {
+        if (not hay_siguiente[f] and not acabada[f]) desencolar(f);
+        if (hay_siguiente[f] and (m == -1 or siguiente[f].secuencia < siguiente[m].secuencia)) m = f;
+    }
+    if (m == -1) return false;
+    com = move(siguiente[m]);
+    hay_siguiente[m] = false;
+    return true;
+}
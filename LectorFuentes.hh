@@ -0,0 +1,116 @@
+/** @file LectorFuentes.hh
+    @brief Especificación de la clase LectorFuentes */
+
+#ifndef LECTOR_FUENTES_HH
+#define LECTOR_FUENTES_HH
+
+#include "Comando.hh"
+#include "LectorComandos.hh"
+
+#ifndef NO_DIAGRAM
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ColaSPSC.hh"
+#endif
+using namespace std;
+
+/** @class LectorFuentes
+    @brief Lee comandos de varias fuentes a la vez (ficheros o FIFOs) y los da en un solo
+    orden. Cada fuente es una entrada de texto secuenciada (ver <em>LectorComandos</em>)
+    con los números de secuencia en orden estrictamente creciente (los comandos que no lo
+    cumplen se descartan con un error), y se lee en un hilo propio que deja sus comandos
+    en una cola acotada de la fuente: si una fuente va por delante de las demás, su hilo
+    espera a que haya sitio. Los comandos salen en orden creciente de número de secuencia
+    y, a igualdad, en el orden en que se han dado las fuentes: uno solo sale cuando todas
+    las fuentes que no se han acabado tienen alguno pendiente, así que el orden no depende
+    de lo rápido que llegue cada fuente.
+    Por lo mismo, mientras una fuente no se acaba no sale ningún comando más allá de lo
+    que ya ha dado: un FIFO que nadie llega a abrir para escribir deja el lector (y el
+    programa) esperando indefinidamente.
+*/
+class LectorFuentes {
+
+private:
+
+    /** @brief Elemento de la cola de una fuente: un comando, o la marca de que se ha
+        acabado con la indicación de si se había podido abrir */
+    struct Leido {
+        bool fin;
+        bool abierta;
+        Comando com;
+    };
+
+    /** @brief Capacidad de la cola de cada fuente */
+    static const int TAM_COLA = 1024;
+
+    vector<string> rutas;
+
+    /** @brief Cola de cada fuente, que llena su hilo */
+    vector< unique_ptr< ColaSPSC<Leido> > > colas;
+
+    /** @brief Siguiente comando de cada fuente ya desencolado, indicación de si lo hay y
+        de si la fuente se ha acabado */
+    vector<Comando> siguiente;
+    vector<bool> hay_siguiente;
+    vector<bool> acabada;
+
+    /** @brief Número de secuencia del último comando desencolado de cada fuente, e
+        indicación de si ha habido alguno */
+    vector<long long> ultima;
+    vector<bool> hay_ultima;
+
+    /** @brief Hilos que leen las fuentes */
+    vector<thread> hilos;
+
+    /** @brief Función privada que lee una fuente
+        \pre 0 <= f < número de fuentes
+        \post Se han encolado todos los comandos de la fuente 'f' hasta <em>fin</em> o el
+        final de la entrada, seguidos de su marca de fin
+    */
+    void leer_fuente(int f);
+
+    /** @brief Función privada que desencola el siguiente comando de una fuente
+        \pre 0 <= f < número de fuentes, la fuente 'f' no se ha acabado y no tiene
+        siguiente comando
+        \post La fuente 'f' tiene siguiente comando o se ha acabado; se han descartado,
+        escribiendo un error por el canal de error, los comandos desencolados con número de
+        secuencia no mayor que el anterior de la fuente, y se ha escrito un error si la
+        fuente se ha acabado sin poderse abrir
+    */
+    void desencolar(int f);
+
+public:
+
+    // Constructores
+
+    /** @brief Creador inicializado
+        \pre <em>Cierto</em>
+        \post El resultado es un lector de las fuentes "rutas", cada una de las cuales ya
+        se está leyendo en su hilo
+    */
+    LectorFuentes(const vector<string>& rutas);
+
+    LectorFuentes(const LectorFuentes&) = delete;
+    LectorFuentes& operator=(const LectorFuentes&) = delete;
+
+    /** @brief Destructora
+        \pre <em>Cierto</em>
+        \post Se han descartado los comandos que quedaban y se han esperado los hilos
+    */
+    ~LectorFuentes();
+
+
+    // Lectura
+
+    /** @brief Lee el siguiente comando
+        \pre <em>Cierto</em>
+        \post Si queda algún comando en alguna fuente, "com" contiene el de menor número de
+        secuencia (el de la primera fuente si hay varios) y el resultado es cierto; si no,
+        el resultado es falso. Se ha escrito un error por el canal de error por cada fuente
+        que no se ha podido abrir y por cada comando descartado por su número de secuencia
+    */
+    bool leer(Comando& com);
+};
+#endif
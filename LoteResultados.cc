@@ -0,0 +1,161 @@
+/** @file LoteResultados.cc
+    @brief Código de la clase LoteResultados */
+
+#include "LoteResultados.hh"
+#if not defined(SIN_SIMD) and (defined(__x86_64__) or defined(__i386__))
+#define CON_SIMD
+#include <immintrin.h>
+#endif
+#ifdef COMPROBAR_SIMD
+#include <algorithm>
+#include <cassert>
+#endif
+using namespace std;
+
+// Funciones privadas
+
+void LoteResultados::marcar_escalar(const char* buf, int n, uint64_t* marcas) {
+    for (int j = 0; j < n; ++j)
+        if (buf[j] >= '0' and buf[j] <= '7') marcas[j/64] |= uint64_t(1) << (j%64);
+}
+
+#ifdef CON_SIMD
+
+__attribute__((target("sse2")))
+void LoteResultados::marcar_sse2(const char* buf, int n, uint64_t* marcas) {
+    const __m128i menor = _mm_set1_epi8('0'-1);
+    const __m128i mayor = _mm_set1_epi8('8');
+    for (int j = 0; j < n; j += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(buf + j));
+        __m128i d = _mm_and_si128(_mm_cmpgt_epi8(v, menor), _mm_cmplt_epi8(v, mayor));
+        marcas[j/64] |= uint64_t((unsigned)_mm_movemask_epi8(d)) << (j%64);
+    }
+}
+
+__attribute__((target("avx2")))
+void LoteResultados::marcar_avx2(const char* buf, int n, uint64_t* marcas) {
+    const __m256i menor = _mm256_set1_epi8('0'-1);
+    const __m256i mayor = _mm256_set1_epi8('8');
+    for (int j = 0; j < n; j += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(buf + j));
+        __m256i d = _mm256_and_si256(_mm256_cmpgt_epi8(v, menor), _mm256_cmpgt_epi8(mayor, v));
+        marcas[j/64] |= uint64_t((unsigned)_mm256_movemask_epi8(d)) << (j%64);
+    }
+}
+
+#else
+
+void LoteResultados::marcar_sse2(const char* buf, int n, uint64_t* marcas) {
+    marcar_escalar(buf, n, marcas);
+}
+
+void LoteResultados::marcar_avx2(const char* buf, int n, uint64_t* marcas) {
+    marcar_escalar(buf, n, marcas);
+}
+
+#endif
+
+
+// Funciones publicas
+
+LoteResultados::LoteResultados() {}
+
+void LoteResultados::decodificar(vector<string>& res) {
+
+    textos.swap(res);
+    res.clear();
+    int n = textos.size();
+
+    // Se juntan todos los resultados en un buffer, separados por un espacio
+    // y con relleno hasta un multiplo de 64 bytes
+    vector<int> pos(n+1);
+    int total = 0;
+    for (int i = 0; i < n; ++i) total += textos[i].size() + 1;
+    string buf;
+    buf.reserve(total + 64);
+    for (int i = 0; i < n; ++i) {
+        pos[i] = buf.size();
+        buf += textos[i];
+        buf += ' ';
+    }
+    pos[n] = buf.size();
+    buf.append((64 - buf.size()%64)%64, ' ');
+
+    // Se marcan los digitos de todo el buffer de una vez
+    int m = buf.size();
+    vector<uint64_t> marcas(m/64, 0);
+#ifdef CON_SIMD
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) marcar_avx2(buf.data(), m, marcas.data());
+    else marcar_sse2(buf.data(), m, marcas.data());
+#else
+    marcar_escalar(buf.data(), m, marcas.data());
+#endif
+#ifdef COMPROBAR_SIMD
+
+    // Todas las versiones tienen que dar las mismas marcas que el bucle normal
+    vector<uint64_t> esperadas(m/64, 0), otras(m/64, 0);
+    marcar_escalar(buf.data(), m, esperadas.data());
+    assert(marcas == esperadas);
+    marcar_sse2(buf.data(), m, otras.data());
+    assert(otras == esperadas);
+#ifdef CON_SIMD
+    if (avx2) {
+        fill(otras.begin(), otras.end(), 0);
+        marcar_avx2(buf.data(), m, otras.data());
+        assert(otras == esperadas);
+    }
+#endif
+#endif
+
+    // Para cada resultado se recorren solo los bits marcados de su tramo
+    // del buffer, emparejando los digitos de dos en dos
+    sets.clear();
+    sets.reserve(total/4);
+    inicio.resize(n+1);
+    for (int i = 0; i < n; ++i) {
+        inicio[i] = sets.size();
+        int x = 0;
+        bool primero = true;
+        int w = pos[i]/64;
+        uint64_t bits = marcas[w] & (~uint64_t(0) << (pos[i]%64));
+        bool fin = false;
+        while (not fin) {
+            while (bits == 0 and (w+1)*64 < pos[i+1]) bits = marcas[++w];
+            if (bits == 0) fin = true;
+            else {
+                int p = w*64 + __builtin_ctzll(bits);
+                if (p >= pos[i+1]) fin = true;
+                else {
+                    if (primero) x = buf[p] - '0';
+                    else sets.push_back(ParInt(x, buf[p] - '0'));
+                    primero = not primero;
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+    inicio[n] = sets.size();
+}
+
+void LoteResultados::asignar(vector<string>& res, vector<ParInt>& s, vector<int>& ini) {
+    textos.swap(res);
+    sets.swap(s);
+    inicio.swap(ini);
+}
+
+int LoteResultados::numero_resultados() const{
+    return textos.size();
+}
+
+const string& LoteResultados::texto(int i) const{
+    return textos[i];
+}
+
+int LoteResultados::numero_sets(int i) const{
+    return inicio[i+1] - inicio[i];
+}
+
+const ParInt& LoteResultados::set(int i, int j) const{
+    return sets[inicio[i] + j];
+}
@@ -0,0 +1,115 @@
+/** @file LoteResultados.hh
+    @brief Especificación de la clase LoteResultados */
+
+#ifndef LOTE_RESULTADOS_HH
+#define LOTE_RESULTADOS_HH
+
+#ifndef NO_DIAGRAM
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "ParInt.hh"
+#endif
+using namespace std;
+
+/** @class LoteResultados
+    @brief Representa los resultados de todos los partidos de un torneo, tal como se leen en preorden.
+    Además del texto de cada resultado, guarda los sets ya convertidos a enteros.
+    La conversión se hace de una vez para todo el lote: los textos se juntan en un
+    solo buffer, se marcan con instrucciones vectoriales (AVX2 o SSE2 si el procesador
+    las tiene, o con un bucle normal si no) las posiciones de los dígitos del 0 al 7,
+    y después se recorren solo las posiciones marcadas para formar los sets.
+*/
+class LoteResultados {
+
+private:
+
+    /** @brief Texto de cada resultado, en preorden y con "0" en los árboles vacíos */
+    vector<string> textos;
+
+    /** @brief Sets de todos los resultados, uno detrás de otro */
+    vector<ParInt> sets;
+
+    /** @brief Los sets del resultado i son los de las posiciones [inicio[i], inicio[i+1]) de "sets" */
+    vector<int> inicio;
+
+    /** @brief Función privada que marca los dígitos válidos de un buffer con un bucle normal
+        \pre n es múltiplo de 64 y "marcas" tiene n/64 palabras a 0
+        \post El bit j de "marcas" (bit j%64 de la palabra j/64) vale 1 si y solo si
+        buf[j] es un dígito entre '0' y '7'
+    */
+    static void marcar_escalar(const char* buf, int n, uint64_t* marcas);
+
+    /** @brief Función privada que marca los dígitos válidos de un buffer con SSE2.
+        Si se compila con SIN_SIMD (o fuera de x86) se usa <em>marcar_escalar</em>; con
+        COMPROBAR_SIMD se comprueba en cada lote que todas las versiones coinciden
+        \pre Las mismas que <em>marcar_escalar</em> y el procesador tiene SSE2
+        \post Las mismas que <em>marcar_escalar</em>
+    */
+    static void marcar_sse2(const char* buf, int n, uint64_t* marcas);
+
+    /** @brief Función privada que marca los dígitos válidos de un buffer con AVX2
+        \pre Las mismas que <em>marcar_escalar</em> y el procesador tiene AVX2
+        \post Las mismas que <em>marcar_escalar</em>
+    */
+    static void marcar_avx2(const char* buf, int n, uint64_t* marcas);
+
+public:
+
+    // Constructor
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un lote sin resultados
+    */
+    LoteResultados();
+
+
+    // Modificador
+
+    /** @brief Asigna al lote un conjunto de resultados y los convierte a sets
+        \pre "res" contiene los resultados de los partidos de un torneo en preorden,
+        con "0" en los árboles vacíos
+        \post El lote contiene los resultados que había en "res", que queda vacío, y
+        los sets de cada uno: cada dos dígitos entre '0' y '7' seguidos dentro de un
+        mismo resultado forman un set, y si sobra un dígito al final se descarta
+    */
+    void decodificar(vector<string>& res);
+
+    /** @brief Asigna al lote un conjunto de resultados ya convertidos a sets
+        \pre "res" contiene los resultados de los partidos de un torneo en preorden, con
+        "0" en los árboles vacíos, "s" sus sets uno detrás de otro y los sets del resultado
+        i son los de las posiciones [ini[i], ini[i+1]) de "s"
+        \post El lote contiene los resultados y los sets que había en "res", "s" e "ini", que
+        pasan a contener lo que tenía antes el lote
+    */
+    void asignar(vector<string>& res, vector<ParInt>& s, vector<int>& ini);
+
+
+    // Consultores
+
+    /** @brief Consultor del número de resultados del lote
+        \pre <em>Cierto</em>
+        \post El resultado es el número de resultados del lote, contando los "0"
+    */
+    int numero_resultados() const;
+
+    /** @brief Consultor del texto de un resultado
+        \pre 0 <= i < numero_resultados()
+        \post El resultado es el texto del resultado i-ésimo en preorden
+    */
+    const string& texto(int i) const;
+
+    /** @brief Consultor del número de sets de un resultado
+        \pre 0 <= i < numero_resultados()
+        \post El resultado es el número de sets del resultado i-ésimo
+    */
+    int numero_sets(int i) const;
+
+    /** @brief Consultor de un set de un resultado
+        \pre 0 <= i < numero_resultados() y 0 <= j < numero_sets(i)
+        \post El resultado es el set j-ésimo del resultado i-ésimo
+    */
+    const ParInt& set(int i, int j) const;
+};
+#endif
@@ -0,0 +1,128 @@
+/** @file Marcador.hh
+    @brief Especificación de los registros ResumenPartido y Marcador */
+
+#ifndef MARCADOR_HH
+#define MARCADOR_HH
+
+#include "Categoria.hh"
+#include "LoteResultados.hh"
+
+#ifndef NO_DIAGRAM
+#include <string>
+#endif
+using namespace std;
+
+/** @struct ResumenPartido
+    @brief Lo que cuenta de un partido para decidir el ganador y las estadísticas */
+struct ResumenPartido {
+
+    /** @brief Número de sets que cuentan */
+    int sets;
+
+    /** @brief Sets y juegos de los sets que cuentan ganados por el primer y el segundo jugador */
+    int sets_primero;
+    int sets_segundo;
+    int juegos_primero;
+    int juegos_segundo;
+
+    /** @brief Indica si gana el partido el primer jugador */
+    bool gana_primero;
+
+    /** @brief Indica si el resultado acaba el partido según el formato */
+    bool decidido;
+};
+
+/** @struct Marcador
+    @brief Interpretación de los resultados según el formato de los partidos.
+    Hay una especialización por cada <em>Categoria::Formato</em>, con una operación
+    <em>resumir</em>(lote, r, res) que deja en "res" el resumen del resultado r-ésimo de
+    "lote". El torneo elige la especialización una vez para todos sus partidos, así que
+    dentro del recorrido no se pregunta por el formato. Para añadir un formato basta con
+    añadir su especialización y su caso donde se elige.
+*/
+template <Categoria::Formato F> struct Marcador;
+
+/** @brief Formato clásico: "1-0" y "0-1" son partidos ganados sin jugar y, si no, cuentan
+    todos los sets, formados por cada dos dígitos entre '0' y '7' del resultado, y gana
+    quien más sets gana (el segundo jugador en caso de empate) */
+template <> struct Marcador<Categoria::CLASICO> {
+
+    static void resumir(const LoteResultados& lote, int r, ResumenPartido& res) {
+        res.sets = lote.numero_sets(r);
+        res.sets_primero = res.sets_segundo = 0;
+        res.juegos_primero = res.juegos_segundo = 0;
+        for (int i = 0; i < res.sets; ++i) {
+            const ParInt& s = lote.set(r, i);
+            res.juegos_primero += s.primer();
+            res.juegos_segundo += s.segon();
+            if (s.primer() > s.segon()) ++res.sets_primero;
+            else ++res.sets_segundo;
+        }
+        const string& t = lote.texto(r);
+        if (t == "1-0") res.gana_primero = true;
+        else if (t == "0-1") res.gana_primero = false;
+        else res.gana_primero = res.sets_primero > res.sets_segundo;
+        res.decidido = true;
+    }
+};
+
+/** @brief Partidos al mejor de N sets: el partido se acaba en cuanto alguien gana
+    N/2 + 1 sets, y los sets que vengan detrás no cuentan; si nadie llega, el resultado
+    no está decidido. Un set puede llevar detrás
+    el resultado de su tie-break entre paréntesis, como en "7-6(5)", que no cuenta como
+    juegos. Los partidos ganados sin jugar ("1-0" o "0-1") son un set de un juego */
+template <int N> struct MarcadorMejorDe {
+
+    /** @brief Sets que hay que ganar */
+    static const int NECESARIOS = N/2 + 1;
+
+    /** @brief Se añade un set al resumen si el partido no se ha acabado todavía */
+    static void anadir_set(int a, int b, ResumenPartido& res) {
+        if (res.sets_primero < NECESARIOS and res.sets_segundo < NECESARIOS) {
+            ++res.sets;
+            res.juegos_primero += a;
+            res.juegos_segundo += b;
+            if (a > b) ++res.sets_primero;
+            else ++res.sets_segundo;
+        }
+    }
+
+    static void resumir(const LoteResultados& lote, int r, ResumenPartido& res) {
+        res.sets = res.sets_primero = res.sets_segundo = 0;
+        res.juegos_primero = res.juegos_segundo = 0;
+
+        // Sin tie-breaks, los sets son los que ya se sacaron al leer el lote; con
+        // alguno, se vuelven a sacar del texto saltando lo que va entre paréntesis
+        const string& t = lote.texto(r);
+        if (t.find('(') == string::npos) {
+            int n = lote.numero_sets(r);
+            for (int i = 0; i < n; ++i) anadir_set(lote.set(r, i).primer(), lote.set(r, i).segon(), res);
+        }
+        else {
+            int x = -1;
+            int parentesis = 0;
+            for (int i = 0; i < (int)t.size(); ++i) {
+                if (t[i] == '(') ++parentesis;
+                else if (t[i] == ')') --parentesis;
+                else if (parentesis == 0 and t[i] >= '0' and t[i] <= '7') {
+                    if (x == -1) x = t[i] - '0';
+                    else {
+                        anadir_set(x, t[i] - '0', res);
+                        x = -1;
+                    }
+                }
+            }
+        }
+        res.gana_primero = res.sets_primero > res.sets_segundo;
+        res.decidido = res.sets_primero == NECESARIOS or res.sets_segundo == NECESARIOS
+            or t == "1-0" or t == "0-1";
+    }
+};
+
+/** @brief Formato al mejor de 3 sets */
+template <> struct Marcador<Categoria::MEJOR_DE_3> : MarcadorMejorDe<3> {};
+
+/** @brief Formato al mejor de 5 sets */
+template <> struct Marcador<Categoria::MEJOR_DE_5> : MarcadorMejorDe<5> {};
+
+#endif
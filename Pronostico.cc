@@ -0,0 +1,184 @@
+/** @file Pronostico.cc
+    @brief Código de la clase Pronostico */
+
+#include "Pronostico.hh"
+#ifndef NO_DIAGRAM
+#include <algorithm>
+#include <climits>
+#include <iomanip>
+#endif
+using namespace std;
+
+// Funciones privadas
+
+void Pronostico::simular_bloque(int ini, int fin, int semilla, int bloque, Memoria& mem) const{
+
+    // Cada bloque tiene su propio generador para que el resultado no dependa
+    // de que hilo haga cada bloque
+    seed_seq sem = {(unsigned int)semilla, (unsigned int)bloque};
+    mt19937_64 gen(sem);
+
+    int na = afectados.size();
+    int nr = resto.size();
+    int t = abiertos.size();
+
+    for (int s = ini; s < fin; ++s) {
+
+        // Se juegan los torneos y se suman los premios a los afectados
+        mem.ptos = ptos_base;
+        for (int i = 0; i < t; ++i) {
+            int m = casilla[i].size();
+            mem.premio.assign(m, 0);
+            abiertos[i].simular(fuerza[i], gen, mem.ganador, mem.premio);
+            for (int j = 0; j < m; ++j)
+                if (casilla[i][j] != -1) mem.ptos[casilla[i][j]] += mem.premio[j];
+        }
+
+        // Los afectados se ordenan igual que el ranking: por puntos y, a igualdad,
+        // por la posicion actual
+        const vector<int>& ptos = mem.ptos;
+        const vector<int>& afec = afectados;
+        mem.orden.resize(na);
+        for (int i = 0; i < na; ++i) mem.orden[i] = i;
+        sort(mem.orden.begin(), mem.orden.end(), [&ptos, &afec](int x, int y) {
+            if (ptos[x] != ptos[y]) return ptos[x] > ptos[y];
+            return afec[x] < afec[y];
+        });
+
+        // El resto ya esta ordenado, asi que el nuevo ranking es la mezcla de los dos
+        int i = 0, j = 0;
+        for (int pos = 1; pos <= n; ++pos) {
+            int x;
+            if (j == nr) x = afec[mem.orden[i++]];
+            else if (i == na) x = resto[j++];
+            else {
+                int a = mem.orden[i], r = resto[j];
+                if (ptos[a] > ptos_ini[r] or (ptos[a] == ptos_ini[r] and afec[a] < r)) {
+                    x = afec[a];
+                    ++i;
+                } else {
+                    x = r;
+                    ++j;
+                }
+            }
+            mem.suma[x] += pos;
+            if (pos < mem.minimo[x]) mem.minimo[x] = pos;
+            if (pos > mem.maximo[x]) mem.maximo[x] = pos;
+        }
+    }
+}
+
+
+// Funciones publicas
+
+Pronostico::Pronostico(const ConjuntoJugadores& jugadores, const vector<Torneo>& iniciados) {
+
+    n = jugadores.numero_jugadores();
+    nombres.resize(n);
+    ptos_ini.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const Jugador& jug = jugadores.consultar_jugador_rank(i+1);
+        nombres[i] = jug.consultar_nombre();
+        ptos_ini[i] = jug.consultar_puntos();
+    }
+
+    abiertos = iniciados;
+    int t = abiertos.size();
+    fuerza.resize(t);
+    casilla.resize(t);
+
+    // Se restan los puntos de las ultimas ediciones y se marcan los jugadores afectados.
+    // En "casilla" se guarda de momento la posicion en el ranking de cada participante
+    vector<int> ptos = ptos_ini;
+    vector<bool> afec(n, false);
+    for (int i = 0; i < t; ++i) {
+
+        const vector<Jugador>& ult = abiertos[i].consultar_ult_edicion();
+        for (int j = 0; j < (int)ult.size(); ++j) {
+            const string& nom = ult[j].consultar_nombre();
+            if (jugadores.existe_jugador(nom)) {
+                int p = jugadores.consultar_jugador(nom).consultar_posicion() - 1;
+                ptos[p] = max(0, ptos[p] - ult[j].consultar_ptos_rest());
+                afec[p] = true;
+            }
+        }
+
+        // La fuerza es la proporcion de partidos ganados con un partido ganado y otro
+        // perdido de mas, para que los jugadores sin partidos tengan fuerza 1/2
+        const vector<Jugador>& part = abiertos[i].consultar_participantes();
+        int m = part.size();
+        fuerza[i].resize(m);
+        casilla[i].assign(m, -1);
+        for (int j = 0; j < m; ++j) {
+            const string& nom = part[j].consultar_nombre();
+            const Jugador* jug = &part[j];
+            if (jugadores.existe_jugador(nom)) {
+                jug = &jugadores.consultar_jugador(nom);
+                casilla[i][j] = jug->consultar_posicion() - 1;
+                afec[casilla[i][j]] = true;
+            }
+            double g = jug->consultar_partidos_ganados();
+            double p = jug->consultar_partidos_perdidos();
+            fuerza[i][j] = (g + 1)/(g + p + 2);
+        }
+    }
+
+    // Se separan los afectados del resto y se pasan las casillas a posiciones en "afectados"
+    vector<int> pos_afec(n, -1);
+    for (int i = 0; i < n; ++i) {
+        if (afec[i]) {
+            pos_afec[i] = afectados.size();
+            afectados.push_back(i);
+            ptos_base.push_back(ptos[i]);
+        } else
+            resto.push_back(i);
+    }
+    for (int i = 0; i < t; ++i)
+        for (int j = 0; j < (int)casilla[i].size(); ++j)
+            if (casilla[i][j] != -1) casilla[i][j] = pos_afec[casilla[i][j]];
+
+    nsim = 0;
+}
+
+void Pronostico::simular(int simulaciones, int semilla, ReservaHilos& hilos) {
+
+    nsim = simulaciones;
+    int nh = hilos.numero_hilos();
+    vector<Memoria> mem(nh);
+
+    // Cada hilo acumula en su propia memoria, que prepara la primera vez que hace un bloque
+    int nbloques = (nsim + TAM_BLOQUE - 1)/TAM_BLOQUE;
+    hilos.ejecutar(nbloques, [this, semilla, &mem](int b, int h) {
+        Memoria& m = mem[h];
+        if (m.suma.empty()) {
+            m.suma.assign(n, 0);
+            m.minimo.assign(n, INT_MAX);
+            m.maximo.assign(n, 0);
+        }
+        simular_bloque(b*TAM_BLOQUE, min(nsim, (b+1)*TAM_BLOQUE), semilla, b, m);
+    });
+
+    // Se juntan los resultados de todos los hilos
+    suma.assign(n, 0);
+    minimo.assign(n, INT_MAX);
+    maximo.assign(n, 0);
+    for (int h = 0; h < nh; ++h) {
+        if (mem[h].suma.empty()) continue;
+        for (int i = 0; i < n; ++i) {
+            suma[i] += mem[h].suma[i];
+            minimo[i] = min(minimo[i], mem[h].minimo[i]);
+            maximo[i] = max(maximo[i], mem[h].maximo[i]);
+        }
+    }
+}
+
+void Pronostico::escribir(ostream& os) const{
+    ios::fmtflags flags = os.flags();
+    streamsize prec = os.precision();
+    os << fixed << setprecision(2);
+    for (int i = 0; i < n; ++i)
+        os << i+1 << ' ' << nombres[i] << ' ' << double(suma[i])/nsim << ' '
+           << minimo[i] << ' ' << maximo[i] << endl;
+    os.flags(flags);
+    os.precision(prec);
+}
@@ -0,0 +1,115 @@
+/** @file Pronostico.hh
+    @brief Especificación de la clase Pronostico */
+
+#ifndef PRONOSTICO_HH
+#define PRONOSTICO_HH
+
+#include "ConjuntoJugadores.hh"
+#include "Torneo.hh"
+#include "ReservaHilos.hh"
+
+/** @class Pronostico
+    @brief Pronóstico del ranking al acabar los torneos iniciados.
+    Simula muchas veces (método de Monte Carlo) todos los torneos iniciados que todavía
+    no se han finalizado y calcula, para cada jugador, la posición media, mínima y máxima
+    que tendría en el ranking. En cada partido, la probabilidad de ganar de cada jugador
+    es proporcional a su fuerza, que sale de sus partidos ganados y perdidos.
+    Solo pueden cambiar los puntos de los participantes de estos torneos y de los de su
+    última edición; el resto de jugadores conserva su orden relativo.
+*/
+class Pronostico {
+
+private:
+
+    /** @brief Número de simulaciones de cada bloque de trabajo */
+    static const int TAM_BLOQUE = 64;
+
+    /** @brief Espacio de trabajo de un hilo, que se reutiliza entre simulaciones */
+    struct Memoria {
+        vector<int> ptos;
+        vector<int> orden;
+        vector<int> ganador;
+        vector<int> premio;
+        vector<long long> suma;
+        vector<int> minimo;
+        vector<int> maximo;
+    };
+
+    /** @brief Número de jugadores */
+    int n;
+
+    /** @brief Nombres de los jugadores en el orden del ranking actual */
+    vector<string> nombres;
+
+    /** @brief Puntos actuales de los jugadores en el orden del ranking actual */
+    vector<int> ptos_ini;
+
+    /** @brief Posiciones (empezando por 0) de los jugadores cuyos puntos pueden cambiar,
+        crecientemente */
+    vector<int> afectados;
+
+    /** @brief Puntos de cada afectado una vez restados los de las últimas ediciones */
+    vector<int> ptos_base;
+
+    /** @brief Posiciones (empezando por 0) del resto de jugadores, crecientemente */
+    vector<int> resto;
+
+    /** @brief Torneos iniciados que se simulan */
+    vector<Torneo> abiertos;
+
+    /** @brief Fuerza de cada participante de cada torneo iniciado */
+    vector< vector<double> > fuerza;
+
+    /** @brief Posición en <em>afectados</em> de cada participante de cada torneo iniciado,
+        o -1 si ya no está en el circuito */
+    vector< vector<int> > casilla;
+
+    /** @brief Número de simulaciones hechas */
+    int nsim;
+
+    /** @brief Suma, mínimo y máximo de la posición de cada jugador en las simulaciones */
+    vector<long long> suma;
+    vector<int> minimo;
+    vector<int> maximo;
+
+    /** @brief Función privada que hace un bloque de simulaciones
+        \pre 0 <= ini <= fin <= nsim, y "mem" tiene espacio para los n jugadores
+        \post Se han hecho las simulaciones [ini, fin) con un generador que solo depende
+        de "semilla" y de "bloque", y se han acumulado sus posiciones en "mem"
+    */
+    void simular_bloque(int ini, int fin, int semilla, int bloque, Memoria& mem) const;
+
+public:
+
+    // Constructor
+
+    /** @brief Creador inicializado
+        \pre El ranking de "jugadores" está actualizado y "iniciados" son los torneos
+        iniciados y no finalizados del circuito
+        \post El resultado es un pronóstico preparado para simular los torneos "iniciados"
+        sobre el ranking actual de "jugadores", sin ninguna simulación hecha
+    */
+    Pronostico(const ConjuntoJugadores& jugadores, const vector<Torneo>& iniciados);
+
+
+    // Modificador
+
+    /** @brief Hace las simulaciones en paralelo
+        \pre "simulaciones" > 0
+        \post Se han hecho "simulaciones" simulaciones con los hilos de "hilos". El
+        resultado solo depende de "semilla" y no del número de hilos
+    */
+    void simular(int simulaciones, int semilla, ReservaHilos& hilos);
+
+
+    // Escritura
+
+    /** @brief Operación de escritura
+        \pre Se han hecho simulaciones
+        \post Se ha escrito a través del canal "os", para cada jugador en el orden del
+        ranking actual, su posición, su nombre y su posición media (con dos decimales),
+        mínima y máxima en las simulaciones
+    */
+    void escribir(ostream& os) const;
+};
+#endif
@@ -0,0 +1,76 @@
+/** @file RankingProvisional.cc
+    @brief Código de la clase RankingProvisional */
+
+#include "RankingProvisional.hh"
+#ifndef NO_DIAGRAM
+#include <algorithm>
+#endif
+using namespace std;
+
+// Cambio de un jugador modificado: nombre, posicion actual y puntos actuales y provisionales
+struct Cambio {
+    string nombre;
+    int pos;
+    int ptos_ant;
+    int ptos;
+};
+
+// Orden del ranking: por puntos y, a igualdad, por la posicion anterior
+static bool cmp_cambio(const Cambio& a, const Cambio& b) {
+    if (a.ptos != b.ptos) return a.ptos > b.ptos;
+    return a.pos < b.pos;
+}
+
+
+// Funciones privadas
+
+int& RankingProvisional::puntos(string_view id_p) {
+    map<string, int, less<> >::iterator it = ptos.find(id_p);
+    if (it == ptos.end())
+        it = ptos.emplace(id_p, base.consultar_jugador(id_p).consultar_puntos()).first;
+    return it->second;
+}
+
+
+// Funciones publicas
+
+RankingProvisional::RankingProvisional(const ConjuntoJugadores& jugadores) : base(jugadores) {}
+
+void RankingProvisional::sumar(string_view id_p, int pt) {
+    if (base.existe_jugador(id_p)) puntos(id_p) += pt;
+}
+
+void RankingProvisional::restar(string_view id_p, int pt) {
+    if (base.existe_jugador(id_p)) {
+        int& p = puntos(id_p);
+        p -= pt;
+        if (p < 0) p = 0;
+    }
+}
+
+void RankingProvisional::escribir_cambios(ostream& os) const{
+
+    // Se ordenan los jugadores modificados con sus puntos provisionales
+    vector<Cambio> v;
+    vector<int> pos_ant;
+    map<string, int, less<> >::const_iterator it;
+    for (it = ptos.begin(); it != ptos.end(); ++it) {
+        const Jugador& jug = base.consultar_jugador(it->first);
+        Cambio c = {it->first, jug.consultar_posicion(), jug.consultar_puntos(), it->second};
+        v.push_back(c);
+        pos_ant.push_back(c.pos);
+    }
+    sort(v.begin(), v.end(), cmp_cambio);
+    sort(pos_ant.begin(), pos_ant.end());
+
+    // Por delante de un jugador modificado quedan los modificados anteriores a el en 'v'
+    // y los no modificados que ya le pasaban en el ranking actual: de los jugadores del
+    // ranking actual que le pasarian, se descuentan los que estan modificados
+    for (int i = 0; i < (int)v.size(); ++i) {
+        int delante = base.contar_delante(v[i].ptos, v[i].pos);
+        int modif = upper_bound(pos_ant.begin(), pos_ant.end(), delante) - pos_ant.begin();
+        int pos = delante - modif + i + 1;
+        os << v[i].nombre << " Rk:" << v[i].pos << "->" << pos
+           << " Ps:" << v[i].ptos_ant << "->" << v[i].ptos << endl;
+    }
+}
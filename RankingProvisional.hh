@@ -0,0 +1,71 @@
+/** @file RankingProvisional.hh
+    @brief Especificación de la clase RankingProvisional */
+
+#ifndef RANKING_PROVISIONAL_HH
+#define RANKING_PROVISIONAL_HH
+
+#include "ConjuntoJugadores.hh"
+
+/** @class RankingProvisional
+    @brief Cambios hipotéticos de puntos sobre el ranking de un conjunto de jugadores.
+    No copia el conjunto: solo guarda los puntos provisionales de los jugadores que se
+    han modificado, y el resto se consulta directamente en el conjunto. Las posiciones
+    provisionales se calculan a partir del ranking actual sin reordenarlo, así que el
+    coste depende del número de jugadores modificados y no del tamaño del circuito.
+*/
+class RankingProvisional {
+
+private:
+
+    /** @brief Conjunto de jugadores sobre el que se hacen los cambios */
+    const ConjuntoJugadores& base;
+
+    /** @brief Puntos provisionales de los jugadores modificados, con su nombre como clave */
+    map<string, int, less<> > ptos;
+
+    /** @brief Función privada que consulta los puntos provisionales de un jugador
+        \pre Existe un Jugador con identificador "id_p" en "base"
+        \post El resultado son los puntos provisionales del Jugador, que se han copiado
+        de "base" si todavía no se había modificado
+    */
+    int& puntos(string_view id_p);
+
+public:
+
+    // Constructor
+
+    /** @brief Creador inicializado
+        \pre El ranking de "jugadores" está actualizado
+        \post El resultado es un ranking provisional sin cambios sobre "jugadores"
+    */
+    RankingProvisional(const ConjuntoJugadores& jugadores);
+
+
+    // Modificadores
+
+    /** @brief Suma puntos provisionales a un Jugador
+        \pre <em>Cierto</em>
+        \post Si existe un Jugador con identificador "id_p", se le han sumado "pt" puntos
+        provisionales; si no, no se ha hecho nada
+    */
+    void sumar(string_view id_p, int pt);
+
+    /** @brief Resta puntos provisionales a un Jugador
+        \pre <em>Cierto</em>
+        \post Si existe un Jugador con identificador "id_p", se le han restado "pt" puntos
+        provisionales sin bajar de 0; si no, no se ha hecho nada
+    */
+    void restar(string_view id_p, int pt);
+
+
+    // Escritura
+
+    /** @brief Operación de escritura de los cambios
+        \pre <em>Cierto</em>
+        \post Se ha escrito a través del canal "os", para cada Jugador modificado y en el
+        orden del ranking provisional, su nombre, su posición actual y la provisional, y
+        sus puntos actuales y los provisionales
+    */
+    void escribir_cambios(ostream& os) const;
+};
+#endif
@@ -0,0 +1,97 @@
+/** @file RegistroPartidos.cc
+    @brief Código de la clase RegistroPartidos */
+
+#include "RegistroPartidos.hh"
+#ifndef NO_DIAGRAM
+#include <algorithm>
+#endif
+using namespace std;
+
+// Funciones privadas
+
+int RegistroPartidos::numerar(const string& nom, map<string, int>& num, vector<string>& noms) {
+    map<string, int>::iterator it = num.find(nom);
+    if (it != num.end()) return it->second;
+    num.insert(it, make_pair(nom, int(noms.size())));
+    noms.push_back(nom);
+    return noms.size() - 1;
+}
+
+
+// Funciones publicas
+
+RegistroPartidos::RegistroPartidos() {
+    inicio.push_back(0);
+}
+
+void RegistroPartidos::registrar(const string& id_to, const vector<Jugador>& part, const vector<int>& a,
+                                 const vector<int>& der, const LoteResultados& lote) {
+
+    int t = numerar(id_to, num_torneo, nom_torneo);
+
+    // Se recorren los partidos en preorden propagando el nivel a los hijos, como
+    // al actualizar las estadisticas
+    int n = der.size();
+    vector<int> nivel(n, 1);
+    for (int i = 0; i < n; ++i) {
+        if (der[i] == -1) continue;
+        nivel[i+1] = nivel[der[i]] = nivel[i] + 1;
+
+        // Los sets estan escritos desde el punto de vista del jugador de la izquierda
+        bool gana_izq = a[i] == a[i+1];
+        int g = numerar(part[a[i]-1].consultar_nombre(), num_jugador, nom_jugador);
+        int p = numerar(part[(gana_izq ? a[der[i]] : a[i+1])-1].consultar_nombre(), num_jugador, nom_jugador);
+
+        int m = ganador.size();
+        ganador.push_back(g);
+        perdedor.push_back(p);
+        torneo.push_back(t);
+        ronda.push_back(nivel[i]);
+        for (int j = 0; j < lote.numero_sets(i); ++j) {
+            int x = min(lote.set(i, j).primer(), 255);
+            int y = min(lote.set(i, j).segon(), 255);
+            if (not gana_izq) swap(x, y);
+            sets.push_back((x << 8) | y);
+        }
+        inicio.push_back(sets.size());
+        parejas[make_pair(min(g, p), max(g, p))].push_back(m);
+    }
+}
+
+int RegistroPartidos::numero_partidos() const{
+    return ganador.size();
+}
+
+void RegistroPartidos::escribir_cara_a_cara(const string& id_a, const string& id_b, ostream& os) const{
+
+    // Si alguno de los dos no ha jugado nunca, no hay partidos entre ellos
+    const vector<int>* v = NULL;
+    map<string, int>::const_iterator ia = num_jugador.find(id_a);
+    map<string, int>::const_iterator ib = num_jugador.find(id_b);
+    if (ia != num_jugador.end() and ib != num_jugador.end()) {
+        pair<int, int> clave(min(ia->second, ib->second), max(ia->second, ib->second));
+        map<pair<int, int>, vector<int> >::const_iterator it = parejas.find(clave);
+        if (it != parejas.end()) v = &it->second;
+    }
+
+    int gana_a = 0, gana_b = 0;
+    if (v != NULL) {
+        for (int k = 0; k < (int)v->size(); ++k) {
+            if (ganador[(*v)[k]] == ia->second) ++gana_a;
+            else ++gana_b;
+        }
+    }
+    os << id_a << ' ' << id_b << ' ' << gana_a << '-' << gana_b << endl;
+
+    if (v != NULL) {
+        for (int k = 0; k < (int)v->size(); ++k) {
+            int m = (*v)[k];
+            os << nom_torneo[torneo[m]] << ' ' << int(ronda[m]) << ' ' << nom_jugador[ganador[m]] << ' ';
+            for (int j = inicio[m]; j < inicio[m+1]; ++j) {
+                if (j > inicio[m]) os << ',';
+                os << (sets[j] >> 8) << '-' << (sets[j] & 255);
+            }
+            os << endl;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/** @file RegistroPartidos.hh
+    @brief Especificación de la clase RegistroPartidos */
+
+#ifndef REGISTRO_PARTIDOS_HH
+#define REGISTRO_PARTIDOS_HH
+
+#include "Jugador.hh"
+#include "LoteResultados.hh"
+
+#ifndef NO_DIAGRAM
+#include <map>
+#include <string>
+#include <vector>
+#endif
+using namespace std;
+
+/** @class RegistroPartidos
+    @brief Historial de todos los partidos disputados en el circuito.
+    Los partidos se guardan por columnas: ganador, perdedor, torneo, ronda y el inicio
+    de sus sets, con los jugadores y los torneos representados por un número que se
+    asigna la primera vez que aparecen. Cada set ocupa 16 bits, con los juegos del
+    ganador en el byte alto y los del perdedor en el bajo. Para cada pareja de jugadores
+    que se ha enfrentado se guarda la lista de sus partidos.
+*/
+class RegistroPartidos {
+
+private:
+
+    /** @brief Número de cada jugador que ha aparecido, con su nombre como clave */
+    map<string, int> num_jugador;
+
+    /** @brief Nombre de cada número de jugador */
+    vector<string> nom_jugador;
+
+    /** @brief Número de cada torneo que ha aparecido, con su nombre como clave */
+    map<string, int> num_torneo;
+
+    /** @brief Nombre de cada número de torneo */
+    vector<string> nom_torneo;
+
+    /** @brief Columnas de los partidos */
+    vector<int> ganador;
+    vector<int> perdedor;
+    vector<int> torneo;
+    vector<unsigned char> ronda;
+
+    /** @brief Los sets del partido i son los de las posiciones [inicio[i], inicio[i+1]) de <em>sets</em> */
+    vector<int> inicio;
+    vector<unsigned short> sets;
+
+    /** @brief Partidos de cada pareja de jugadores, con la pareja (menor, mayor) como clave */
+    map<pair<int, int>, vector<int> > parejas;
+
+    /** @brief Función privada que numera un nombre
+        \pre <em>Cierto</em>
+        \post El resultado es el número de "nom" en "num", que se ha añadido al final
+        de "noms" si no tenía
+    */
+    static int numerar(const string& nom, map<string, int>& num, vector<string>& noms);
+
+public:
+
+    // Constructor
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un registro sin partidos
+    */
+    RegistroPartidos();
+
+
+    // Modificador
+
+    /** @brief Se añaden los partidos de una edición finalizada de un torneo
+        \pre "part" son los participantes de la edición del torneo "id_to", "lote" sus
+        resultados en preorden, "der" la forma de los resultados y 'a' el resultado de
+        <em>proc_resultados</em>
+        \post Se han añadido al registro todos los partidos de la edición
+    */
+    void registrar(const string& id_to, const vector<Jugador>& part, const vector<int>& a,
+                   const vector<int>& der, const LoteResultados& lote);
+
+
+    // Consultor
+
+    /** @brief Consultor del número de partidos
+        \pre <em>Cierto</em>
+        \post El resultado es el número de partidos del registro
+    */
+    int numero_partidos() const;
+
+
+    // Escritura
+
+    /** @brief Operación de escritura del cara a cara de dos jugadores
+        \pre <em>Cierto</em>
+        \post Se ha escrito a través del canal "os" una línea con los nombres de los dos
+        jugadores y los partidos que ha ganado cada uno contra el otro, y después una línea
+        por partido, en el orden en que se han registrado, con el torneo, la ronda, el
+        ganador y los sets desde el punto de vista del ganador
+    */
+    void escribir_cara_a_cara(const string& id_a, const string& id_b, ostream& os) const;
+};
+#endif
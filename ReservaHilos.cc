@@ -0,0 +1,114 @@
+/** @file ReservaHilos.cc
+    @brief Código de la clase ReservaHilos */
+
+#include "ReservaHilos.hh"
+#include "Traza.hh"
+using namespace std;
+
+// Funciones privadas
+
+void ReservaHilos::trabajar(int h) {
+    long long vista = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lck(mtx);
+            while (not acabar and ronda == vista) cv_inicio.wait(lck);
+            if (acabar) return;
+            vista = ronda;
+        }
+        procesar(h);
+        {
+            lock_guard<mutex> lck(mtx);
+            if (--activos == 0) cv_fin.notify_one();
+        }
+    }
+}
+
+void ReservaHilos::procesar(int h) {
+    int b;
+    while (obtener(h, b)) {
+        TRAZA_TRAMO("bloque");
+        (*tarea)(b, h);
+    }
+}
+
+bool ReservaHilos::obtener(int h, int& b) {
+
+    // Primero se mira la cola propia, por delante
+    {
+        Cola& c = *colas[h];
+        lock_guard<mutex> lck(c.mtx);
+        if (not c.bloques.empty()) {
+            b = c.bloques.front();
+            c.bloques.pop_front();
+            return true;
+        }
+    }
+
+    // Si esta vacia se roba por detras de las demas, empezando por la siguiente
+    for (int k = 1; k < nhilos; ++k) {
+        Cola& c = *colas[(h + k) % nhilos];
+        lock_guard<mutex> lck(c.mtx);
+        if (not c.bloques.empty()) {
+            b = c.bloques.back();
+            c.bloques.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Funciones publicas
+
+ReservaHilos::ReservaHilos() {
+    nhilos = thread::hardware_concurrency();
+    if (nhilos < 1) nhilos = 1;
+    for (int h = 0; h < nhilos; ++h) colas.push_back(unique_ptr<Cola>(new Cola));
+    tarea = NULL;
+    ronda = 0;
+    activos = 0;
+    acabar = false;
+}
+
+ReservaHilos::~ReservaHilos() {
+    {
+        lock_guard<mutex> lck(mtx);
+        acabar = true;
+    }
+    cv_inicio.notify_all();
+    for (int i = 0; i < (int)hilos.size(); ++i) hilos[i].join();
+}
+
+void ReservaHilos::ejecutar(int nbloques, const function<void(int,int)>& f) {
+
+    // Los hilos se crean la primera vez que hacen falta
+    if (hilos.empty())
+        for (int h = 1; h < nhilos; ++h) hilos.push_back(thread(&ReservaHilos::trabajar, this, h));
+
+    // Se reparten los bloques en partes contiguas, una por hilo
+    for (int h = 0; h < nhilos; ++h) {
+        Cola& c = *colas[h];
+        lock_guard<mutex> lck(c.mtx);
+        for (int b = (long long)nbloques*h/nhilos; b < (long long)nbloques*(h+1)/nhilos; ++b)
+            c.bloques.push_back(b);
+    }
+
+    {
+        lock_guard<mutex> lck(mtx);
+        tarea = &f;
+        activos = nhilos - 1;
+        ++ronda;
+    }
+    cv_inicio.notify_all();
+
+    // El hilo que llama trabaja como hilo 0 y despues espera a los demas
+    procesar(0);
+    unique_lock<mutex> lck(mtx);
+    while (activos > 0) cv_fin.wait(lck);
+    tarea = NULL;
+}
+
+int ReservaHilos::numero_hilos() const{
+    return nhilos;
+}
@@ -0,0 +1,111 @@
+/** @file ReservaHilos.hh
+    @brief Especificación de la clase ReservaHilos */
+
+#ifndef RESERVA_HILOS_HH
+#define RESERVA_HILOS_HH
+
+#ifndef NO_DIAGRAM
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+using namespace std;
+
+/** @class ReservaHilos
+    @brief Grupo de hilos de trabajo con robo de tareas.
+    Ejecuta en paralelo un número de bloques de trabajo independientes. Cada hilo
+    empieza con una parte contigua de los bloques en su propia cola y los va sacando
+    por delante; cuando se queda sin bloques, roba por detrás de la cola de otro hilo.
+    Los hilos se crean la primera vez que se usa el grupo y se reutilizan después.
+*/
+class ReservaHilos {
+
+private:
+
+    /** @brief Cola de bloques de un hilo */
+    struct Cola {
+        mutex mtx;
+        deque<int> bloques;
+    };
+
+    int nhilos;
+    vector<thread> hilos;
+    vector< unique_ptr<Cola> > colas;
+
+    mutex mtx;
+    condition_variable cv_inicio;
+    condition_variable cv_fin;
+
+    /** @brief Tarea de la ronda actual */
+    const function<void(int,int)>* tarea;
+
+    /** @brief Número de la ronda actual; los hilos esperan a que cambie */
+    long long ronda;
+
+    /** @brief Hilos que todavía están trabajando en la ronda actual */
+    int activos;
+
+    bool acabar;
+
+    /** @brief Función privada que ejecutan los hilos del grupo
+        \pre 1 <= h < nhilos
+        \post El hilo ha trabajado en cada ronda hasta que se ha destruido el grupo
+    */
+    void trabajar(int h);
+
+    /** @brief Función privada que ejecuta bloques hasta que no queda ninguno
+        \pre 0 <= h < nhilos y hay una ronda en marcha
+        \post Se han ejecutado con el hilo h los bloques de su cola y los que ha podido robar
+    */
+    void procesar(int h);
+
+    /** @brief Función privada que obtiene el siguiente bloque para un hilo
+        \pre 0 <= h < nhilos
+        \post Si queda algún bloque, 'b' es uno de ellos (de la cola de h si tiene, robado
+        de otra si no), se ha quitado de su cola y el resultado es cierto; si no, es falso
+    */
+    bool obtener(int h, int& b);
+
+public:
+
+    // Constructor y destructora
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un grupo con tantos hilos como núcleos tiene la máquina
+    */
+    ReservaHilos();
+
+    /** @brief Destructora
+        \pre No hay ninguna ronda en marcha
+        \post Se han acabado y esperado todos los hilos del grupo
+    */
+    ~ReservaHilos();
+
+
+    // Modificador
+
+    /** @brief Ejecuta en paralelo un conjunto de bloques de trabajo
+        \pre "f" puede ejecutarse a la vez desde varios hilos para bloques distintos
+        \post Se ha llamado una vez a f(b, h) para cada bloque 0 <= b < nbloques, donde h
+        (0 <= h < numero_hilos()) identifica el hilo que lo ha ejecutado; dos bloques
+        con el mismo h nunca se ejecutan a la vez. El hilo que llama también trabaja
+        (con h = 0) y la operación no acaba hasta que se han ejecutado todos los bloques
+    */
+    void ejecutar(int nbloques, const function<void(int,int)>& f);
+
+
+    // Consultor
+
+    /** @brief Consultor del número de hilos
+        \pre <em>Cierto</em>
+        \post El resultado es el número de hilos que pueden trabajar a la vez, contando
+        el que llama a <em>ejecutar</em>
+    */
+    int numero_hilos() const;
+};
+#endif
@@ -0,0 +1,186 @@
+/** @file ServidorConsultas.cc
+    @brief Código de la clase ServidorConsultas */
+
+#include "ServidorConsultas.hh"
+#ifndef NO_DIAGRAM
+#include <sstream>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+using namespace std;
+
+// Milisegundos que esperan los hilos del servidor antes de volver a comprobar si deben acabar
+const int ESPERA = 100;
+
+// Funciones privadas
+
+void ServidorConsultas::aceptar() {
+    while (activo) {
+        pollfd p;
+        p.fd = fd;
+        p.events = POLLIN;
+        if (poll(&p, 1, ESPERA) > 0) {
+            int cli = accept(fd, NULL, NULL);
+            if (cli >= 0) {
+                clientes.emplace_back();
+                Cliente& c = clientes.back();
+                c.acabado = false;
+                c.hilo = thread(&ServidorConsultas::atender, this, cli, ref(c.acabado));
+            }
+        }
+
+        // Se esperan los hilos de los clientes que ya se han ido, para que la lista
+        // solo tenga los conectados
+        list<Cliente>::iterator it = clientes.begin();
+        while (it != clientes.end()) {
+            if (it->acabado) {
+                it->hilo.join();
+                it = clientes.erase(it);
+            }
+            else ++it;
+        }
+    }
+}
+
+void ServidorConsultas::atender(int cli, atomic<bool>& acabado) {
+    string pendiente;
+    char buf[4096];
+    bool abierto = true;
+    while (activo and abierto) {
+        pollfd p;
+        p.fd = cli;
+        p.events = POLLIN;
+        if (poll(&p, 1, ESPERA) <= 0) continue;
+
+        int n = read(cli, buf, sizeof(buf));
+        if (n <= 0) abierto = false;
+        else {
+            pendiente.append(buf, n);
+
+            // Se responde cada linea completa sobre la instantanea vigente en ese momento
+            size_t fin = pendiente.find('\n');
+            while (abierto and fin != string::npos) {
+                shared_ptr<const Instantanea> ins = atomic_load(&actual);
+                ostringstream os;
+                responder(pendiente.substr(0, fin), *ins, os);
+                string s = os.str();
+                size_t env = 0;
+                while (abierto and env < s.size()) {
+                    int m = send(cli, s.data() + env, s.size() - env, MSG_NOSIGNAL);
+                    if (m <= 0) abierto = false;
+                    else env += m;
+                }
+                pendiente.erase(0, fin+1);
+                fin = pendiente.find('\n');
+            }
+        }
+    }
+    close(cli);
+    acabado = true;
+}
+
+void ServidorConsultas::responder(const string& linea, const Instantanea& ins, ostream& os) {
+    istringstream is(linea);
+    string com;
+    if (is >> com) {
+        if (com == "listar_ranking" or com == "lr") {
+            os << '#' << com << endl;
+            ins.jugadores.listar_ranking(os);
+        }
+        else if (com == "listar_jugadores" or com == "lj") {
+            os << '#' << com << endl;
+            ins.jugadores.listar_jugadores(os);
+        }
+        else if (com == "consultar_jugador" or com == "cj") {
+            string id_p;
+            is >> id_p;
+            os << '#' << com << ' ' << id_p << endl;
+            if (ins.jugadores.existe_jugador(id_p))
+                ins.jugadores.consultar_jugador(id_p).listar_jugador(os);
+            else
+                os << "error: el jugador no existe" << endl;
+        }
+        else if (com == "buscar_jugador" or com == "bsj") {
+            string prefijo;
+            is >> prefijo;
+            os << '#' << com << ' ' << prefijo << endl;
+            ins.jugadores.buscar_jugadores(prefijo, os);
+        }
+        else if (com == "listar_torneos" or com == "lt") {
+            os << '#' << com << endl;
+            ins.torneos.listar_torneos(os);
+        }
+        else
+            os << "error: consulta no admitida" << endl;
+        os << "epoca " << ins.epoca << endl;
+    }
+}
+
+
+// Funciones publicas
+
+ServidorConsultas::ServidorConsultas() {
+    epoca = 0;
+    fd = -1;
+    activo = false;
+}
+
+ServidorConsultas::~ServidorConsultas() {
+    detener();
+}
+
+bool ServidorConsultas::iniciar(const string& r) {
+
+    sockaddr_un dir;
+    if (r.size() >= sizeof(dir.sun_path)) return false;
+    memset(&dir, 0, sizeof(dir));
+    dir.sun_family = AF_UNIX;
+    strcpy(dir.sun_path, r.c_str());
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    unlink(r.c_str());
+    if (bind(fd, (sockaddr*)&dir, sizeof(dir)) < 0 or listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    ruta = r;
+    activo = true;
+    aceptador = thread(&ServidorConsultas::aceptar, this);
+    return true;
+}
+
+void ServidorConsultas::publicar(const ConjuntoJugadores& jugadores, const ConjuntoTorneos& torneos) {
+
+    // La instantanea se prepara fuera de la publicada: los lectores siguen usando
+    // la anterior hasta que se sustituye de forma atomica. Las copias comparten con
+    // los conjuntos las partes que no se modifiquen hasta la siguiente
+    shared_ptr<Instantanea> ins = make_shared<Instantanea>();
+    ins->epoca = ++epoca;
+    ins->jugadores = jugadores.instantanea();
+    ins->torneos = torneos;
+    atomic_store(&actual, shared_ptr<const Instantanea>(ins));
+}
+
+void ServidorConsultas::detener() {
+    if (not activo) return;
+    activo = false;
+    aceptador.join();
+
+    // Ya no se aceptan clientes nuevos: se esperan los que quedan
+    list<Cliente>::iterator it;
+    for (it = clientes.begin(); it != clientes.end(); ++it) it->hilo.join();
+    clientes.clear();
+    close(fd);
+    fd = -1;
+    unlink(ruta.c_str());
+}
+
+bool ServidorConsultas::en_marcha() const{
+    return activo;
+}
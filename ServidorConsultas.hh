@@ -0,0 +1,131 @@
+/** @file ServidorConsultas.hh
+    @brief Especificación de la clase ServidorConsultas */
+
+#ifndef SERVIDOR_CONSULTAS_HH
+#define SERVIDOR_CONSULTAS_HH
+
+#include "ConjuntoJugadores.hh"
+#include "ConjuntoTorneos.hh"
+
+#ifndef NO_DIAGRAM
+#include <atomic>
+#include <list>
+#include <memory>
+#include <thread>
+#endif
+
+/** @class ServidorConsultas
+    @brief Servidor de consultas de solo lectura sobre un socket local (Unix).
+    Los clientes envían líneas con las consultas <em>listar_ranking</em>,
+    <em>listar_jugadores</em>, <em>consultar_jugador</em>, <em>buscar_jugador</em> y <em>listar_torneos</em>
+    (o sus abreviaturas) y reciben la misma salida que daría el programa principal,
+    terminada con una línea "epoca N".
+    Las consultas se responden sobre una instantánea inmutable del circuito. El hilo
+    que aplica los comandos publica una instantánea nueva después de cada modificación;
+    cada consulta toma la instantánea vigente y la conserva mientras la usa, de modo
+    que nunca espera al hilo escritor ni ve un estado a medio modificar. Las
+    instantáneas antiguas se liberan cuando las deja de usar el último lector, y las
+    partes del circuito que no cambian entre una y otra se comparten en lugar de copiarse
+    (ver <em>ConjuntoJugadores::instantanea</em>).
+*/
+class ServidorConsultas {
+
+private:
+
+    /** @brief Copia inmutable del circuito publicada en una época */
+    struct Instantanea {
+        long long epoca;
+        ConjuntoJugadores jugadores;
+        ConjuntoTorneos torneos;
+    };
+
+    /** @brief Instantánea vigente; se lee y se publica con operaciones atómicas */
+    shared_ptr<const Instantanea> actual;
+
+    long long epoca;
+    string ruta;
+    int fd;
+    atomic<bool> activo;
+    thread aceptador;
+
+    /** @brief Hilo que atiende a un cliente e indicación de si ya ha acabado */
+    struct Cliente {
+        thread hilo;
+        atomic<bool> acabado;
+    };
+
+    /** @brief Clientes que todavía no se han esperado; solo los toca el hilo que acepta
+        las conexiones mientras el servidor está activo */
+    list<Cliente> clientes;
+
+    /** @brief Función privada que acepta conexiones mientras el servidor está activo
+        \pre El socket de escucha está abierto
+        \post Se ha creado un hilo por cada cliente conectado hasta detener el servidor,
+        y se han esperado los de los clientes que ya se habían desconectado
+    */
+    void aceptar();
+
+    /** @brief Función privada que atiende las consultas de un cliente
+        \pre "cli" es el descriptor de la conexión con el cliente
+        \post Se han respondido las consultas del cliente hasta que este ha cerrado
+        la conexión o se ha detenido el servidor, se ha cerrado la conexión y
+        "acabado" es cierto
+    */
+    void atender(int cli, atomic<bool>& acabado);
+
+    /** @brief Función privada que responde una consulta sobre una instantánea
+        \pre "linea" contiene una consulta y "ins" es una instantánea publicada
+        \post Se ha escrito en "os" la respuesta a la consulta
+    */
+    static void responder(const string& linea, const Instantanea& ins, ostream& os);
+
+public:
+
+    // Constructores
+
+    /** @brief Creador por defecto
+        \pre <em>Cierto</em>
+        \post El resultado es un servidor detenido sin ninguna instantánea publicada
+    */
+    ServidorConsultas();
+
+    /** @brief Destructora
+        \pre <em>Cierto</em>
+        \post Se ha detenido el servidor si estaba activo
+    */
+    ~ServidorConsultas();
+
+
+    // Modificadores
+
+    /** @brief Pone en marcha el servidor
+        \pre El servidor está detenido
+        \post Si se ha podido crear el socket en la ruta "r", el servidor acepta
+        conexiones en un hilo propio y el resultado es cierto; si no, es falso
+    */
+    bool iniciar(const string& r);
+
+    /** @brief Publica una nueva instantánea del circuito
+        \pre <em>Cierto</em>
+        \post Las consultas que empiecen a partir de ahora ven el estado actual de
+        "jugadores" y "torneos" con la época siguiente a la anterior
+    */
+    void publicar(const ConjuntoJugadores& jugadores, const ConjuntoTorneos& torneos);
+
+    /** @brief Detiene el servidor
+        \pre <em>Cierto</em>
+        \post Se han cerrado todas las conexiones, se han esperado los hilos del
+        servidor y se ha eliminado el socket
+    */
+    void detener();
+
+
+    // Consultor
+
+    /** @brief Consultor del estado del servidor
+        \pre <em>Cierto</em>
+        \post El resultado indica si el servidor está aceptando conexiones
+    */
+    bool en_marcha() const;
+};
+#endif
@@ -0,0 +1,102 @@
+/** @file Tokenizador.cc
+    @brief Código de la clase Tokenizador */
+
+#include "Tokenizador.hh"
+#ifndef NO_DIAGRAM
+#include <thread>
+#include <cctype>
+#include <sys/stat.h>
+#endif
+using namespace std;
+
+// Tamaño minimo (en bytes) de un trozo para que valga la pena darle un hilo propio
+const int MIN_TROZO = 1 << 16;
+
+// Bytes que se leen cada vez cuando no se sabe de antemano el tamaño del fichero
+const int TAM_BLOQUE = 1 << 16;
+
+// Funciones privadas
+
+void Tokenizador::separar(const string& texto, size_t ini, size_t fin, vector<string>& tokens) {
+    size_t i = ini;
+    while (i < fin) {
+        while (i < fin and isspace((unsigned char)texto[i])) ++i;
+        size_t j = i;
+        while (j < fin and not isspace((unsigned char)texto[j])) ++j;
+        if (j > i) tokens.push_back(texto.substr(i, j-i));
+        i = j;
+    }
+}
+
+
+bool Tokenizador::leer_texto(const string& fichero, ifstream& f, string& texto) {
+
+    // Si es un fichero normal se lee entero de una vez
+    struct stat st;
+    if (stat(fichero.c_str(), &st) == 0 and S_ISREG(st.st_mode)) {
+        f.seekg(0, ios::end);
+        streamoff n = f.tellg();
+        f.seekg(0, ios::beg);
+        if (n >= 0 and f) {
+            texto.resize(n);
+            if (n > 0) f.read(&texto[0], n);
+            texto.resize(f.gcount());
+            return not f.bad();
+        }
+        f.clear();
+        f.seekg(0, ios::beg);
+    }
+
+    // Si no (un FIFO, por ejemplo), o no se sabe su tamaño, se lee por bloques hasta el final
+    texto.clear();
+    char buf[TAM_BLOQUE];
+    while (f.read(buf, TAM_BLOQUE) or f.gcount() > 0) texto.append(buf, f.gcount());
+    return not f.bad();
+}
+
+
+// Funciones publicas
+
+bool Tokenizador::leer_fichero(const string& fichero, vector<string>& tokens) {
+
+    ifstream f(fichero.c_str(), ios::in | ios::binary);
+    if (not f) return false;
+
+    string texto;
+    if (not leer_texto(fichero, f, texto)) return false;
+    size_t n = texto.size();
+
+    // Se decide en cuantos trozos se parte el texto
+    size_t nhilos = thread::hardware_concurrency();
+    if (nhilos < 1) nhilos = 1;
+    if (nhilos > n/MIN_TROZO + 1) nhilos = n/MIN_TROZO + 1;
+
+    // Los limites de cada trozo se desplazan hasta el siguiente espacio
+    // para no partir ninguna palabra entre dos hilos
+    vector<size_t> lim(nhilos+1);
+    lim[0] = 0;
+    lim[nhilos] = n;
+    for (size_t i = 1; i < nhilos; ++i) {
+        size_t x = n*i/nhilos;
+        if (x < lim[i-1]) x = lim[i-1];
+        while (x < n and not isspace((unsigned char)texto[x])) ++x;
+        lim[i] = x;
+    }
+
+    // Cada hilo separa su trozo y al final se juntan en orden
+    vector< vector<string> > parcial(nhilos);
+    vector<thread> hilos;
+    for (size_t i = 1; i < nhilos; ++i)
+        hilos.push_back(thread(separar, cref(texto), lim[i], lim[i+1], ref(parcial[i])));
+    separar(texto, lim[0], lim[1], parcial[0]);
+    for (int i = 0; i < (int)hilos.size(); ++i) hilos[i].join();
+
+    size_t total = 0;
+    for (size_t i = 0; i < nhilos; ++i) total += parcial[i].size();
+    tokens.clear();
+    tokens.reserve(total);
+    for (size_t i = 0; i < nhilos; ++i)
+        for (size_t j = 0; j < parcial[i].size(); ++j)
+            tokens.push_back(move(parcial[i][j]));
+    return true;
+}
@@ -0,0 +1,48 @@
+/** @file Tokenizador.hh
+    @brief Especificación de la clase Tokenizador */
+
+#ifndef TOKENIZADOR_HH
+#define TOKENIZADOR_HH
+
+#ifndef NO_DIAGRAM
+#include <fstream>
+#include <string>
+#include <vector>
+#endif
+using namespace std;
+
+/** @class Tokenizador
+    @brief Lectura masiva de ficheros de texto.
+    Lee un fichero entero en memoria y lo separa en palabras (secuencias de
+    caracteres sin espacios) repartiendo el trabajo en trozos que se procesan
+    en paralelo, uno por hilo. El orden de las palabras se conserva.
+*/
+class Tokenizador {
+
+private:
+
+    /** @brief Función privada que separa en palabras un trozo del texto
+        \pre 0 <= ini <= fin <= texto.size()
+        \post Se han añadido a "tokens" las palabras de texto[ini, fin) en el
+        orden en el que aparecen
+    */
+    static void separar(const string& texto, size_t ini, size_t fin, vector<string>& tokens);
+
+    /** @brief Función privada que lee un fichero entero
+        \pre "f" está abierto al principio del fichero "fichero"
+        \post Si se ha podido leer, "texto" contiene todo el contenido de "f" y el resultado
+        es cierto; si no, el resultado es falso
+    */
+    static bool leer_texto(const string& fichero, ifstream& f, string& texto);
+
+public:
+
+    /** @brief Lee todas las palabras de un fichero
+        \pre <em>Cierto</em>
+        \post Si el fichero "fichero" se ha podido abrir y leer, "tokens" contiene sus
+        palabras en el orden del fichero y el resultado es cierto; si no (por ejemplo,
+        si es un directorio), el resultado es falso y "tokens" no se ha modificado
+    */
+    static bool leer_fichero(const string& fichero, vector<string>& tokens);
+};
+#endif
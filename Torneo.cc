@@ -2,54 +2,111 @@
     @brief Código de la clase Torneo */
 
 #include "Torneo.hh"
+#include "Marcador.hh"
+#include "Traza.hh"
 #ifndef NO_DIAGRAM
 #include <cmath>
 #endif
 using namespace std;
 
-// Funciones privadas
+// Funciones auxiliares de escritura
+
+// Añade a "buf" el numero x en decimal
+static void escribir_entero(string& buf, int x) {
+    char dig[12];
+    int n = 0;
+    do {
+        dig[n++] = '0' + x%10;
+        x /= 10;
+    } while (x > 0);
+    while (n > 0) buf += dig[--n];
+}
 
-vector<ParInt> Torneo::conv(const string& res) {
+// Añade a "buf" el participante x de 'v' con el formato "x.nombre"
+static void escribir_participante(string& buf, int x, const vector<Jugador>& v) {
+    escribir_entero(buf, x);
+    buf += '.';
+    buf += v[x-1].consultar_nombre();
+}
 
-    vector<ParInt> v;
-    int n = res.length();
-    int x, y, cont = 0;
+// Calcula en "fin", para cada nodo de un arbol en preorden con hijos derechos "der",
+// la posicion siguiente al final de su subarbol
+static void calcular_fin(const vector<int>& der, vector<int>& fin) {
+    int n = der.size();
+    fin.resize(n);
+    for (int i = n-1; i >= 0; --i) fin[i] = (der[i] == -1) ? i+1 : fin[der[i]];
+}
 
-    for (int i = 0; i < n; ++i) {
-        if (res[i] >= '0' and res[i] <= '7') {
-            if (cont == 0) x = res[i] - '0';
-            else y = res[i] - '0';
-            ++cont;
-        }
 
-        if (cont == 2) {
-            ParInt p(x,y);
-            v.push_back(p);
-            cont = 0;
-        }
+// Funciones privadas
+
+template <class M> int Torneo::match(int a, int b, const LoteResultados& lote, int r) {
+    ResumenPartido res;
+    M::resumir(lote, r, res);
+    return res.gana_primero ? a : b;
+}
+
+template <class M> void Torneo::procesar(vector<int>& a, const LoteResultados& lote, const vector<int>& der) const{
+
+    // Los hijos de un nodo estan siempre detras de el en preorden, asi que
+    // recorriendo los nodos de atras hacia delante ya se conocen sus ganadores
+    int n = der.size();
+    a.resize(n);
+    for (int i = n-1; i >= 0; --i) {
+        if (der[i] == -1) a[i] = cuadro_pre[i];
+        else a[i] = match<M>(a[i+1], a[der[i]], lote, i);
     }
-    return v;
 }
 
-int Torneo::match(int a, int b, const string& res) {
+template <class M> bool Torneo::estadisticas_partido(int a, int b, const LoteResultados& lote, int r, ConjuntoJugadores& jugadores, int nivel) {
 
-    if (res == "1-0") return a;
-    else if (res == "0-1") return b;
-    else {
+    // Si un participante se ha dado de baja desde que empezo el torneo no se toca nada
+    const string& id_a = jug_edicion_actual[a-1].consultar_nombre();
+    const string& id_b = jug_edicion_actual[b-1].consultar_nombre();
+    if (not jugadores.existe_jugador(id_a) or not jugadores.existe_jugador(id_b)) return false;
 
-        // vector de sets dels resultats
-        vector<ParInt> v = conv(res);
-        int n = v.size();
-        int x = 0, y = 0;
+    // Los sets y los juegos solo cuentan si el partido tiene mas de un set
+    ResumenPartido res;
+    M::resumir(lote, r, res);
+    if (res.sets != 1) {
+        for (int i = 0; i < res.sets_primero; ++i) jugadores.sumar_restar_set(a, b, jug_edicion_actual);
+        for (int i = 0; i < res.sets_segundo; ++i) jugadores.sumar_restar_set(b, a, jug_edicion_actual);
+        jugadores.sumar_restar_juegos(a, b, res.juegos_primero, res.juegos_segundo, jug_edicion_actual);
+    }
 
-        for (int i = 0; i < n; ++i) {
-            if (v[i].primer() > v[i].segon()) ++x;
-            else ++y;
-        }
+    // El rating solo cambia en los partidos jugados, que son los que cuentan sets. El perdedor
+    // se queda con los puntos del nivel siguiente, y el ganador de la final con los del 1
+    int ganador = res.gana_primero ? a : b;
+    int perdedor = res.gana_primero ? b : a;
+    jugadores.sumar_restar_partido(ganador, perdedor, res.sets != 1, jug_edicion_actual);
+    jugadores.sumar_puntos(cat, nivel+1, perdedor, jug_edicion_actual);
+    if (nivel == 1) jugadores.sumar_puntos(cat, 1, ganador, jug_edicion_actual);
+    return true;
+}
+
+template <class M> bool Torneo::estadisticas(const vector<int>& a, const LoteResultados& lote, const vector<int>& der, ConjuntoJugadores& jugadores) {
+
+    // El nivel de cada partido se propaga en preorden a sus hijos, que estan detras. Los
+    // partidos se aplican al reves, de las primeras rondas a la final, porque el rating
+    // depende del orden en que se han jugado
+    int n = der.size();
+    vector<int> nivel(n, 1);
+    for (int i = 0; i < n; ++i)
+        if (der[i] != -1) nivel[i+1] = nivel[der[i]] = nivel[i] + 1;
+    for (int i = n-1; i >= 0; --i)
+        if (der[i] != -1 and not estadisticas_partido<M>(a[i+1], a[der[i]], lote, i, jugadores, nivel[i])) return false;
+    return true;
+}
 
-        if (x > y) return a;
-        else return b;
+template <class M> bool Torneo::decididos(const LoteResultados& lote, const vector<int>& der) {
+    ResumenPartido res;
+    for (int i = 0; i < (int)der.size(); ++i) {
+        if (der[i] != -1) {
+            M::resumir(lote, i, res);
+            if (not res.decidido) return false;
+        }
     }
+    return true;
 }
 
 
@@ -57,222 +114,291 @@ int Torneo::match(int a, int b, const string& res) {
 
 Torneo::Torneo() {
     id = " ";
+    iniciado = false;
+    edicion = 0;
 }
 
-Torneo::Torneo(string& id_to) {
-    id = id_to;
+Torneo::Torneo(string id_to) {
+    id = move(id_to);
+    iniciado = false;
+    edicion = 0;
 }
 
-Torneo::Torneo(string& id_to, Categoria& ca) {
-    id = id_to;
+Torneo::Torneo(string id_to, const Categoria& ca) {
+    id = move(id_to);
     cat = ca;
+    iniciado = false;
+    edicion = 0;
 }
 
-void Torneo::definir_emparejamientos(BinTree<int>& arb, int h, int l, int a, int x) {
+void Torneo::definir_emparejamientos(vector<int>& pre, vector<int>& der, int h, int l, int a, int x) const{
 
-    // Si estamos en el ultimo nivel, tenemos un nodo sin hijos
-    if (l == h) 
-        arb = BinTree<int>(a);
-    
-    // Si no estamos en el ultimo nivel:
-    else {
+    // El nodo va delante de sus hijos en preorden
+    int i = pre.size();
+    pre.push_back(a);
+    der.push_back(-1);
 
-        // Si a es del nivel h-1 y a <= m-1, tenemos un nodo sin hijos
-        if (l == h-1 and a <= x) 
-            arb = BinTree<int>(a);  
-        
-        else {
-            int b = pow(2, l) + 1 - a;
-            BinTree<int> izq(a);
-            BinTree<int> der(b);
-            definir_emparejamientos(izq, h, l+1, a, x);
-            definir_emparejamientos(der, h, l+1, b, x);
-            arb = BinTree<int>(a,izq,der);
-        } 
+    // Si estamos en el ultimo nivel, o a es del nivel h-1 y a <= x, tenemos un nodo
+    // sin hijos; si no, el izquierdo va justo detras y el derecho despues de este
+    if (l < h and not (l == h-1 and a <= x)) {
+        int b = pow(2, l) + 1 - a;
+        definir_emparejamientos(pre, der, h, l+1, a, x);
+        der[i] = pre.size();
+        definir_emparejamientos(pre, der, h, l+1, b, x);
     }
 }
 
-void Torneo::asignar_cuadro_emp_participantes(const BinTree<int>& arb, const vector<Jugador>& r) {
-    cuadro_emp = arb;
-    jug_edicion_actual = r;
+void Torneo::asignar_cuadro_emp_participantes(vector<int> pre, vector<int> der, vector<Jugador> r) {
+    TRAZA_TRAMO("asignar_cuadro_emp_participantes");
+    cuadro_pre = move(pre);
+    cuadro_der = move(der);
+    jug_edicion_actual = move(r);
+    iniciado = true;
 }
 
-void Torneo::proc_resultados(BinTree<int>& a, const BinTree<int>& emp, const BinTree<string>& res) {
-
-    if (emp.left().empty() and emp.right().empty()) {
-        int x = emp.value();
-        a = BinTree<int>(x);
-    }
-
-    else {
+void Torneo::definir_formato(Categoria::Formato f) {
+    cat.definir_formato(f);
+}
 
-        BinTree<int> izq = emp.left();
-        BinTree<int> der = emp.right();
+void Torneo::proc_resultados(vector<int>& a, const LoteResultados& lote, const vector<int>& der) const{
+    TRAZA_TRAMO("proc_resultados");
 
-        BinTree<string> izq2 = res.left();
-        BinTree<string> der2 = res.right();
+    // El formato se elige una vez para todo el cuadro
+    Categoria::Formato f = cat.consultar_formato();
+    if (f == Categoria::MEJOR_DE_3) procesar< Marcador<Categoria::MEJOR_DE_3> >(a, lote, der);
+    else if (f == Categoria::MEJOR_DE_5) procesar< Marcador<Categoria::MEJOR_DE_5> >(a, lote, der);
+    else procesar< Marcador<Categoria::CLASICO> >(a, lote, der);
+}
 
-        BinTree<int> i;
-        BinTree<int> d;
+void Torneo::calcular_premios(const vector<int>& a, const vector<int>& der, vector<int>& premio) const{
 
-        proc_resultados(i, izq, izq2);
-        proc_resultados(d, der, der2);
-        
-        int x = match(i.value(), d.value(), res.value());
-        a = BinTree<int>(x, i, d);
+    // Cada participante pierde un partido, y se queda con los puntos del nivel
+    // siguiente al del partido, menos el ganador de la final, que se queda con
+    // los del nivel 1
+    int n = der.size();
+    premio.assign(jug_edicion_actual.size(), 0);
+    vector<int> nivel(n, 1);
+    for (int i = 0; i < n; ++i) {
+        if (der[i] != -1) {
+            nivel[i+1] = nivel[der[i]] = nivel[i] + 1;
+            int perdedor = a[i+1] == a[i] ? a[der[i]] : a[i+1];
+            premio[perdedor-1] = cat.consultar_puntos(nivel[i]+1);
+        }
     }
+    if (n > 0 and der[0] != -1) premio[a[0]-1] = cat.consultar_puntos(1);
 }
 
-void Torneo::act_stats(int a, int b, const string& res, ConjuntoJugadores& jugadores, int nivel) {
+bool Torneo::actualizar_estadisticas(const vector<int>& a, const LoteResultados& lote, const vector<int>& der, ConjuntoJugadores& jugadores) {
+    TRAZA_TRAMO("actualizar_estadisticas");
+
+    // El formato se elige una vez para todos los partidos
+    Categoria::Formato f = cat.consultar_formato();
+    if (f == Categoria::MEJOR_DE_3) return estadisticas< Marcador<Categoria::MEJOR_DE_3> >(a, lote, der, jugadores);
+    else if (f == Categoria::MEJOR_DE_5) return estadisticas< Marcador<Categoria::MEJOR_DE_5> >(a, lote, der, jugadores);
+    else return estadisticas< Marcador<Categoria::CLASICO> >(a, lote, der, jugadores);
+}
 
-    vector<ParInt> v = conv(res);
-    int n = v.size();
-    int x = 0, y = 0;
-    int juegos_a = 0, juegos_b = 0;
+void Torneo::restar_puntos(ConjuntoJugadores& jugadores) const{
+    TRAZA_TRAMO("restar_puntos");
 
-    if (n != 1) {
+    int n = jug_ult_edicion.size();
+    if (n != 0) {
         for (int i = 0; i < n; ++i) {
-            juegos_a += v[i].primer();
-            juegos_b += v[i].segon();
-
-            if (v[i].primer() > v[i].segon()) {
-                jugadores.sumar_restar_set(a, b, jug_edicion_actual);
-                ++x;
-            } else {
-                jugadores.sumar_restar_set(b, a, jug_edicion_actual);
-                ++y;
-            }
+            int x = jug_ult_edicion[i].consultar_ptos_rest();
+            jugadores.restar(jug_ult_edicion[i].consultar_nombre(), x, cat.consultar_id());
         }
+    }
+}
 
-        jugadores.sumar_restar_juegos(a, b, juegos_a, juegos_b, jug_edicion_actual);
-    
-        if (x > y) {
-            jugadores.sumar_restar_partido(a, b, jug_edicion_actual);
-            jugadores.sumar_puntos(cat, nivel+1, b, jug_edicion_actual);
+void Torneo::ult_jugadores(vector<Jugador> last, int ed) {
+    jug_ult_edicion = move(last);
+    iniciado = false;
+    edicion = ed;
+}
 
-        } else {
-            jugadores.sumar_restar_partido(b, a, jug_edicion_actual);
-            jugadores.sumar_puntos(cat, nivel+1, a, jug_edicion_actual);
-        }
+void Torneo::caducar_puntos(int i, string& id_p, int& pt) {
+    id_p = jug_ult_edicion[i-1].consultar_nombre();
+    pt = jug_ult_edicion[i-1].consultar_ptos_rest();
+    jug_ult_edicion[i-1].anular_ptos_torneo();
+}
 
-        if (nivel == 1) {
-            if (x > y) 
-                jugadores.sumar_puntos(cat, 1, a, jug_edicion_actual);
-            else 
-                jugadores.sumar_puntos(cat, 1, b, jug_edicion_actual);
-        }
+void Torneo::anular_puntos() {
+    for (int i = 0; i < (int)jug_ult_edicion.size(); ++i)
+        jug_ult_edicion[i].anular_ptos_torneo();
+}
 
-    } else {
+void Torneo::simular(const vector<double>& fuerza, mt19937_64& gen, vector<int>& ganador, vector<int>& premio) const{
 
-        if (v[0].primer() > v[0].segon()) {
-            jugadores.sumar_restar_partido(a, b, jug_edicion_actual);
-            jugadores.sumar_puntos(cat, nivel+1, b, jug_edicion_actual);
-        } else {
-            jugadores.sumar_restar_partido(b, a, jug_edicion_actual);
-            jugadores.sumar_puntos(cat, nivel+1, a, jug_edicion_actual);
-        }
-        if (nivel == 1) {
-            if (v[0].primer() > v[0].segon()) 
-                jugadores.sumar_puntos(cat, 1, a, jug_edicion_actual);
-            else 
-                jugadores.sumar_puntos(cat, 1, b, jug_edicion_actual);
+    // Primero se guarda en "ganador" el nivel de cada nodo, que se propaga en preorden
+    // hacia los hijos. Despues se juegan los partidos de atras hacia delante: al llegar
+    // al nodo i su nivel todavia esta en ganador[i] y los de sus hijos ya son ganadores
+    int n = cuadro_pre.size();
+    ganador.assign(n, 1);
+    for (int i = 0; i < n; ++i)
+        if (cuadro_der[i] != -1) ganador[i+1] = ganador[cuadro_der[i]] = ganador[i] + 1;
+
+    uniform_real_distribution<double> azar(0.0, 1.0);
+    for (int i = n-1; i >= 0; --i) {
+        if (cuadro_der[i] == -1) ganador[i] = cuadro_pre[i];
+        else {
+            int nivel = ganador[i];
+            int a = ganador[i+1], b = ganador[cuadro_der[i]];
+            double fa = fuerza[a-1], fb = fuerza[b-1];
+            if (azar(gen)*(fa + fb) >= fa) swap(a, b);
+
+            // 'a' es el ganador: el perdedor se queda con los puntos del nivel
+            // siguiente y el ganador de la final con los del nivel 1
+            premio[b-1] = cat.consultar_puntos(nivel+1);
+            if (nivel == 1) premio[a-1] = cat.consultar_puntos(1);
+            ganador[i] = a;
         }
-        
     }
 }
 
-void Torneo::actualizar_estadisticas(const BinTree<int>& a, const BinTree<string>& res, int nivel, ConjuntoJugadores& jugadores) {
+const vector<Jugador>& Torneo::consultar_participantes() const{
+    return jug_edicion_actual;
+}
 
-    if (not res.empty()) {
-        act_stats(a.left().value(), a.right().value(), res.value(), jugadores, nivel);
-        actualizar_estadisticas(a.left(), res.left(), nivel+1, jugadores);
-        actualizar_estadisticas(a.right(), res.right(), nivel+1, jugadores);
-    }
+const vector<Jugador>& Torneo::consultar_ult_edicion() const{
+    return jug_ult_edicion;
 }
 
-void Torneo::restar_puntos(ConjuntoJugadores& jugadores) {
+bool Torneo::esta_iniciado() const{
+    return iniciado;
+}
 
-    int n = jug_ult_edicion.size();
-    if (n != 0) {
-        for (int i = 0; i < n; ++i) {
-            string id_p = jug_ult_edicion[i].consultar_nombre();
-            int x = jug_ult_edicion[i].consultar_ptos_rest();
-            jugadores.restar(id_p, x);
-        }
-    }
+int Torneo::consultar_edicion() const{
+    return edicion;
 }
 
-void Torneo::ult_jugadores(vector<Jugador>& last) {
-    jug_ult_edicion = last;
+int Torneo::consultar_id_categoria() const{
+    return cat.consultar_id();
 }
 
-BinTree<int> Torneo::consultar_cuadro() const{
-    return cuadro_emp;
+void Torneo::leer_participantes(vector<Jugador>& r, const vector<int>& pos, const ConjuntoJugadores& jugadores) const{
+    TRAZA_TRAMO("leer_participantes");
+    int n = r.size();
+    for (int i = 0; i < n; ++i) 
+        r[i] = jugadores.consultar_jugador_rank(pos[i]);
 }
 
-vector<Jugador> Torneo::consultar_participantes() const{
-    return jug_edicion_actual;
+void Torneo::leer_resultados(const LoteResultados& lote, vector<int>& der) { 
+    TRAZA_TRAMO("leer_resultados");
+
+    int n = lote.numero_resultados();
+    der.assign(n, -1);
+
+    // Pila de los partidos con algun subarbol todavia por acabar: si no se conoce 
+    // su hijo derecho, se esta leyendo el izquierdo
+    vector<int> pila;
+    for (int i = 0; i < n; ++i) {
+        if (lote.texto(i) != "0") pila.push_back(i);
+        else {
+
+            // Se ha acabado un subarbol: si era el izquierdo de un partido, el derecho
+            // empieza a continuacion; si era el derecho, tambien se ha acabado el partido
+            bool seguir = true;
+            while (seguir and not pila.empty()) {
+                int t = pila.back();
+                if (der[t] == -1) {
+                    der[t] = i+1;
+                    seguir = false;
+                } 
+                else pila.pop_back();
+            }
+        }
+    }
 }
 
-void Torneo::leer_participantes(vector<Jugador>& r, ConjuntoJugadores& jugadores) {
-    int n = r.size();
-    int x;
+bool Torneo::resultados_validos(const LoteResultados& lote, const vector<int>& der) const{
+    int n = der.size();
+    if (n != (int)cuadro_der.size()) return false;
     for (int i = 0; i < n; ++i) {
-        cin >> x;
-        r[i] = jugadores.consultar_jugador_rank(x);
+        if (der[i] != cuadro_der[i]) return false;
+        if (der[i] != -1 and lote.numero_sets(i) == 0) return false;
     }
+
+    // En el formato clasico cualquier resultado tiene ganador
+    Categoria::Formato f = cat.consultar_formato();
+    if (f == Categoria::MEJOR_DE_3) return decididos< Marcador<Categoria::MEJOR_DE_3> >(lote, der);
+    else if (f == Categoria::MEJOR_DE_5) return decididos< Marcador<Categoria::MEJOR_DE_5> >(lote, der);
+    return true;
 }
 
-void Torneo::leer_resultados(BinTree<string>& a) { 
+void Torneo::imprimir_emparejamientos(const vector<int>& pre, const vector<int>& der, const vector<Jugador>& v, ostream& os) const{
+    TRAZA_TRAMO("imprimir_emparejamientos");
 
-    string x;
-    cin >> x;
+    vector<int> fin;
+    calcular_fin(der, fin);
+    int n = pre.size();
 
-    if (x != "0") {
-        BinTree<string> izq;
-        BinTree<string> der;
-        leer_resultados(izq);
-        leer_resultados(der); 
-        a = BinTree<string>(x,izq,der);
-    }
-}    
+    vector<bool> es_der(n, false);
+    for (int i = 0; i < n; ++i) 
+        if (der[i] != -1) es_der[der[i]] = true;
 
-void Torneo::imprimir_emparejamientos(const BinTree<int> &a, const vector<Jugador>& v) const{
-    
-    if (a.left().empty() and a.right().empty())
-        cout << a.value() << '.' << v[a.value()-1].consultar_nombre();
-    else {
-        cout << '(';
-        imprimir_emparejamientos(a.left(), v);
-        cout << ' ';
-        imprimir_emparejamientos(a.right(), v);
-        cout << ')';
+    // Se escribe el cuadro en preorden en un buffer. En la pila se guarda el final 
+    // de los partidos abiertos para cerrar su parentesis al llegar a el
+    string buf;
+    buf.reserve(16*n);
+    vector<int> pila;
+    for (int i = 0; i < n; ++i) {
+        while (not pila.empty() and pila.back() <= i) {
+            buf += ')';
+            pila.pop_back();
+        }
+        if (es_der[i]) buf += ' ';
+        if (der[i] == -1) escribir_participante(buf, pre[i], v);
+        else {
+            buf += '(';
+            pila.push_back(fin[i]);
+        }
     }
+    buf.append(pila.size(), ')');
+    os.write(buf.data(), buf.size());
 }
 
-void Torneo::imprimir_resultados(const BinTree<int>& a, const BinTree<string>& res) const{
-    
-    if (not a.left().empty() and not a.right().empty()) {
-        cout << '(';
-        cout << a.left().value() << '.' << jug_edicion_actual[a.left().value()-1].consultar_nombre() << " vs ";
-        cout << a.right().value() << '.' << jug_edicion_actual[a.right().value()-1].consultar_nombre() << ' ' << res.value();
-        imprimir_resultados(a.left(), res.left());
-        imprimir_resultados(a.right(), res.right());
-        cout << ')';
-    } 
+void Torneo::imprimir_resultados(const vector<int>& a, const LoteResultados& lote, const vector<int>& der, ostream& os) const{
+    TRAZA_TRAMO("imprimir_resultados");
+
+    vector<int> fin;
+    calcular_fin(der, fin);
+    int n = der.size();
+
+    // Igual que en el cuadro de emparejamientos, pero solo se escriben los partidos
+    string buf;
+    buf.reserve(32*n);
+    vector<int> pila;
+    for (int i = 0; i < n; ++i) {
+        while (not pila.empty() and pila.back() <= i) {
+            buf += ')';
+            pila.pop_back();
+        }
+        if (der[i] != -1) {
+            buf += '(';
+            escribir_participante(buf, a[i+1], jug_edicion_actual);
+            buf += " vs ";
+            escribir_participante(buf, a[der[i]], jug_edicion_actual);
+            buf += ' ';
+            buf += lote.texto(i);
+            pila.push_back(fin[i]);
+        }
+    }
+    buf.append(pila.size(), ')');
+    os.write(buf.data(), buf.size());
 }
 
-void Torneo::listar_puntos() const{
+void Torneo::listar_puntos(ostream& os) const{
+    TRAZA_TRAMO("listar_puntos");
 
     int n = jug_edicion_actual.size();
     for (int i = 0; i < n; ++i) {
         if (jug_edicion_actual[i].consultar_ptos_rest() != 0) 
-            cout  << i+1 << '.' << jug_edicion_actual[i].consultar_nombre() << ' ' << jug_edicion_actual[i].consultar_ptos_rest() << endl;
+            os  << i+1 << '.' << jug_edicion_actual[i].consultar_nombre() << ' ' << jug_edicion_actual[i].consultar_ptos_rest() << endl;
     }
 }
 
-void Torneo::listar_torneo() const{
-    cout << id << ' ' << cat.consultar_nombre_categoria() << endl;
+void Torneo::listar_torneo(ostream& os) const{
+    os << id << ' ' << cat.consultar_nombre_categoria() << endl;
 }
 
 
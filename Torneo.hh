@@ -7,14 +7,15 @@
 #include "ConjuntoJugadores.hh"
 
 #ifndef NO_DIAGRAM 
-#include "BinTree.hh"
 #include "ParInt.hh"
+#include "LoteResultados.hh"
+#include <random>
 #endif
 
 /** @class Torneo
     @brief Representa un torneo.
     Se identifica con un string y pertenece a una <em>Categoria</em>.
-    Contiene un <em>BinTree</em> que representa el cuadro de emparejamientos al inicio del Torneo,
+    Contiene el cuadro de emparejamientos al inicio del Torneo, en preorden,
     un vector de jugadores que contiene los participantes de la edición actual del Torneo, y
     otro de la última.
 */
@@ -25,9 +26,19 @@ private:
     string id;
     Categoria cat;
     
-    /** @brief Es un <em>BinTree</em> (arbol) de enteros que representa el cuadro de 
-        emparejamientos del Torneo */
-    BinTree<int> cuadro_emp; 
+    /** @brief Valores del cuadro de emparejamientos en preorden. Los resultados de
+        <em>finalizar_torneo</em> también se leen en preorden, así que el resultado
+        i-ésimo es el del nodo i-ésimo de este vector */
+    vector<int> cuadro_pre;
+
+    /** @brief Para cada nodo de <em>cuadro_pre</em>, la posición de su hijo derecho, o -1 si no tiene hijos */
+    vector<int> cuadro_der;
+
+    /** @brief Indica si el Torneo se ha iniciado y todavía no se ha finalizado */
+    bool iniciado;
+
+    /** @brief Número de la última edición finalizada, único en todo el circuito, o 0 si no hay */
+    int edicion;
 
     /** @brief Vector de <em>Jugador</em> que contiene los participantes de la edición actual del Torneo */
     vector<Jugador> jug_edicion_actual;
@@ -35,20 +46,43 @@ private:
     /** @brief Vector de <em>Jugador</em> que contiene los participantes de la última edición del Torneo */
     vector<Jugador> jug_ult_edicion;
 
-    /** @brief Función privada que convierte un string que representa el resultado de un partido
-        en un vector de sets, donde cada set es un <em>ParInt</em> con el resultado del set 
-        \pre <em>Cierto</em>
-        \post El resultado es un vector de <em>ParInt</em> con los resultados de los sets
-        en forma de enteros
+    /** @brief Función privada que devuelve el ganador de un partido entre dos jugadores
+        \pre 'a' y 'b' son dos enteros que representan a dos jugadores dentro del torneo, 'r' es
+        la posición en "lote" del resultado del partido y M es un <em>Marcador</em>
+        \post El resultado es un entero que representa al jugador que resulta ganador del
+        partido según el formato de M
     */
-    static vector<ParInt> conv(const string& res);
+    template <class M> static int match(int a, int b, const LoteResultados& lote, int r);
 
-    /** @brief Función privada que devuelve el ganador de un partido entre dos jugadores
-        \pre 'a' y 'b' son dos enteros que representan a dos jugadores dentro del torneo, y "res" es
-        un string que representa el resultado de partido
-        \post El resultado es un entero que representa al jugador que resulta ganador del partido
+    /** @brief Función privada que hace <em>proc_resultados</em> con el formato de M
+        \pre Las de <em>proc_resultados</em> y M es el <em>Marcador</em><F> del formato F de
+        la Categoria
+        \post Las de <em>proc_resultados</em>
+    */
+    template <class M> void procesar(vector<int>& a, const LoteResultados& lote, const vector<int>& der) const;
+
+    /** @brief Función privada que actualiza las estadísticas de los dos jugadores de un partido
+        \pre 'a' y 'b' son dos participantes que se enfrentan en un partido de nivel "nivel",
+        'r' es la posición en "lote" de su resultado y M es el <em>Marcador</em><F> del
+        formato F de la Categoria
+        \post Si los dos jugadores siguen en el circuito, se han actualizado sus estadísticas
+        según el resumen que da M del resultado y el resultado es cierto; si no, no se ha
+        modificado nada y el resultado es falso
+    */
+    template <class M> bool estadisticas_partido(int a, int b, const LoteResultados& lote, int r, ConjuntoJugadores& jugadores, int nivel);
+
+    /** @brief Función privada que hace <em>actualizar_estadisticas</em> con el formato de M
+        \pre Las de <em>actualizar_estadisticas</em> y M es el <em>Marcador</em><F> del formato F
+        de la Categoria
+        \post Las de <em>actualizar_estadisticas</em>
     */
-    static int match(int a, int b, const string& res);
+    template <class M> bool estadisticas(const vector<int>& a, const LoteResultados& lote, const vector<int>& der, ConjuntoJugadores& jugadores);
+
+    /** @brief Función privada que comprueba que los partidos acaban con el formato de M
+        \pre "der" es el resultado de <em>leer_resultados</em> sobre "lote" y M es un <em>Marcador</em>
+        \post El resultado indica si todos los partidos de "lote" están decididos según M
+    */
+    template <class M> static bool decididos(const LoteResultados& lote, const vector<int>& der);
 
     
 public:
@@ -67,7 +101,7 @@ public:
         \pre <em>Cierto</em>
         \post El resultado es un Torneo con id = id_to
     */
-    Torneo(string& id_to);
+    Torneo(string id_to);
     
     /** @brief Creador inicializado.
         Se genera automáticamente un Torneo inicializado con su identificador
@@ -75,122 +109,187 @@ public:
         \pre <em>Cierto</em>
         \post El resultado es un Torneo con id = id_to y Categoria = cat
     */
-    Torneo(string& id_to, Categoria& ca);
+    Torneo(string id_to, const Categoria& ca);
     
     
     // Modificadores
     
     /** @brief Confecciona y define el cuadro de emparejamientos del Torneo
-        \pre 'arb' es un árbol vacío, 'h' es la altura que tendrá el árbol, 
-        'l' representa el nivel que en la primera llamada es 1, 'a' representa el ganador 
-        y también debe ser 1. Y 'x' es el valor de los jugadores que no tendrán hijos
-        en caso de que el último nivel del árbol sea incompleto
-        \post Se ha definido el cuadro de emparejamientos del Torneo 
+        \pre 'h' es la altura que tendrá el árbol del cuadro, 'l' representa el nivel que en
+        la primera llamada es 1, 'a' representa el ganador y también debe ser 1. Y 'x' es
+        el valor de los jugadores que no tendrán hijos en caso de que el último nivel del
+        árbol sea incompleto
+        \post Se han añadido a "pre" los valores del subárbol del cuadro con raíz 'a' en el
+        nivel 'l', en preorden, y a "der", para cada uno, la posición en "pre" de su hijo
+        derecho, o -1 si no tiene hijos (el izquierdo siempre es el siguiente)
     */
-    void definir_emparejamientos(BinTree<int>& arb, int h, int l, int a, int x);
+    void definir_emparejamientos(vector<int>& pre, vector<int>& der, int h, int l, int a, int x) const;
 
     /** @brief Se asigna al parámetro implícito el cuadro de emparejamientos 
         y el vector de participantes del Torneo
-        \pre "arb" es un arbol de enteros que contiene el cuadro de emparejamientos y r es
-        un vector de jugadores con los participantes del Torneo
+        \pre "pre" y "der" son el cuadro de emparejamientos que da <em>definir_emparejamientos</em>
+        y r es un vector de jugadores con los participantes del Torneo
         \post Se ha asignado al Torneo el cuadro de emparejamientos y el vector de participantes
         de la edición actual
     */
-    void asignar_cuadro_emp_participantes(const BinTree<int>& arb, const vector<Jugador>& r);
+    void asignar_cuadro_emp_participantes(vector<int> pre, vector<int> der, vector<Jugador> r);
+
+    /** @brief Se cambia el formato de los partidos del Torneo
+        \pre <em>Cierto</em>
+        \post Los resultados del Torneo se interpretan con el formato "f" de su Categoria
+    */
+    void definir_formato(Categoria::Formato f);
     
-    /** @brief Se construye un árbol con los resultados del Torneo
-        \pre 'a' es un árbol vacío, el cuadro de emparejamientos está definido correcamente y 'res' es un árbol de strings
-        con los resultados de los partidos
-        \post 'a' es ahora un árbol con los resultados del Torneo ya disputado
+    /** @brief Se calcula el ganador de cada partido del Torneo
+        \pre El cuadro de emparejamientos está definido correctamente, "lote" contiene los resultados
+        de los partidos en preorden y "der" es el resultado de <em>leer_resultados</em> sobre "lote"
+        \post a[i] es el jugador que llega al nodo i (en preorden) del cuadro de resultados
+        del Torneo ya disputado, según el formato de los partidos de su Categoria
     */
-   void proc_resultados(BinTree<int>& a, const BinTree<int>& emp, const BinTree<string>& res);
-   
-    /** @brief Actualiza las estadísticas de los dos jugadores 
-        que disputan el partido a partir del resultado del mismo
-        \pre 'a' y 'b' son dos enteros que representan a dos jugadores que se enfrentan en un partido
-        y 'res' es un string con el resultado de este partido
-        \post Se han actualizado las estadísticas pertenecientes a los dos jugadores que han participado en el Torneo
+    void proc_resultados(vector<int>& a, const LoteResultados& lote, const vector<int>& der) const;
+
+    /** @brief Se calculan los puntos que consigue cada participante del Torneo
+        \pre 'a' es el resultado de <em>proc_resultados</em> sobre unos resultados con forma "der"
+        \post "premio" tiene un elemento por participante y premio[i-1] son los puntos que
+        consigue el participante i según la Categoria del Torneo
     */
-    void act_stats(int a, int b, const string& res, ConjuntoJugadores& jugadores, int nivel);
+    void calcular_premios(const vector<int>& a, const vector<int>& der, vector<int>& premio) const;
     
     /** @brief Actualiza las estadísticas de los jugadores participantes en el Torneo
-        \pre 'a' es el árbol de enteros que representa los resultados y 
-        'res' el árbol de strings con los resultados de los partidos
-        \post Se han actualizado las estadísticas pertenecientes a cada jugador que ha participado en el Torneo
+        \pre 'a' es el resultado de <em>proc_resultados</em> sobre "lote" y "der"
+        \post Si todos los participantes siguen en el circuito, se han actualizado las estadísticas
+        pertenecientes a cada jugador que ha participado en el Torneo, según el resumen de cada
+        resultado que da el <em>Marcador</em> del formato de la Categoria, y el resultado es cierto; si no,
+        el resultado es falso y solo se han actualizado los partidos anteriores al primero en el que
+        juega un participante que ya no está, así que conviene hacerlo dentro de una transacción
+        de "jugadores"
     */
-    void actualizar_estadisticas(const BinTree<int>& a, const BinTree<string>& res, int nivel, ConjuntoJugadores& jugadores);
+    bool actualizar_estadisticas(const vector<int>& a, const LoteResultados& lote, const vector<int>& der, ConjuntoJugadores& jugadores);
     
     /** @brief Resta los puntos de cada jugador de la última edición del Torneo
         \pre <em>Cierto</em>
         \post Se han restado los puntos de cada jugador de la última edición del Torneo
     */
-    void restar_puntos(ConjuntoJugadores& jugadores);
+    void restar_puntos(ConjuntoJugadores& jugadores) const;
     
     /** @brief Se asigna al Torneo el vector con los jugadores de la última edición
-        \pre "last" es el vector de los participantes de esta edición del torneo
-        \post Se ha asignado/actualizado el vector de jugadores de la última edición del Torneo
+        \pre "last" es el vector de los participantes de esta edición del torneo y "ed"
+        es un número de edición que no se ha usado en el circuito
+        \post Se ha asignado/actualizado el vector de jugadores de la última edición del Torneo,
+        que tiene número "ed"
+    */
+    void ult_jugadores(vector<Jugador> last, int ed);
+
+    /** @brief Caducan los puntos de un participante de la última edición
+        \pre 1 <= i <= número de participantes de la última edición
+        \post "id_p" es el nombre del participante i de la última edición y "pt" los puntos
+        que le quedaban por restar de esta edición, que pasan a ser 0
+    */
+    void caducar_puntos(int i, string& id_p, int& pt);
+
+    /** @brief Se anulan los puntos de todos los participantes de la última edición
+        \pre <em>Cierto</em>
+        \post Los puntos que quedaban por restar de la última edición son 0
+    */
+    void anular_puntos();
+
+    /** @brief Simula una edición del Torneo con el cuadro de emparejamientos actual
+        \pre El Torneo está iniciado, "fuerza" tiene un valor positivo para cada participante
+        (fuerza[i-1] es el del participante i) y "premio" tiene tantos elementos como participantes
+        \post Se han jugado al azar todos los partidos del cuadro, donde el participante i gana
+        a j con probabilidad fuerza[i-1]/(fuerza[i-1]+fuerza[j-1]), y premio[i-1] contiene los
+        puntos que consigue el participante i según la Categoria del Torneo. "ganador" se usa
+        como espacio de trabajo
     */
-    void ult_jugadores(vector<Jugador>& last);
+    void simular(const vector<double>& fuerza, mt19937_64& gen, vector<int>& ganador, vector<int>& premio) const;
     
     
     // Consultores
     
-    /** @brief Consultora del cuadro de emparejamientos del Torneo
-        \pre Cuadro de emparejamientos del torneo definido correctamente
-        \post Se ha devuelto un árbol de enteros que representa el cuadro de emparejamientos del Torneo
-    */
-    BinTree<int> consultar_cuadro() const;
-    
     /** @brief Consultora de los participantes del Torneo
         \pre Vector de participantes del torneo definido correctamente
         \post Se ha devuelto el vector de participantes del Torneo
     */
-    vector<Jugador> consultar_participantes() const;
+    const vector<Jugador>& consultar_participantes() const;
+
+    /** @brief Consultora de los participantes de la última edición del Torneo
+        \pre <em>Cierto</em>
+        \post Se ha devuelto el vector de participantes de la última edición finalizada del
+        Torneo, con los puntos que consiguió cada uno
+    */
+    const vector<Jugador>& consultar_ult_edicion() const;
+
+    /** @brief Consultora del estado del Torneo
+        \pre <em>Cierto</em>
+        \post El resultado indica si el Torneo se ha iniciado y todavía no se ha finalizado
+    */
+    bool esta_iniciado() const;
+
+    /** @brief Consultora de la última edición
+        \pre <em>Cierto</em>
+        \post El resultado es el número de la última edición finalizada del Torneo, o 0 si no hay
+    */
+    int consultar_edicion() const;
+
+    /** @brief Consultora de la Categoria del Torneo
+        \pre <em>Cierto</em>
+        \post El resultado es el identificador de la Categoria a la que pertenece el Torneo
+    */
+    int consultar_id_categoria() const;
     
     
     // Lectura y escritura
 
     /** @brief Operación de lectura
-        \pre Hay preparados en el canal estándar de entrada una serie de enteros que 
-        representan las posiciones del ranking de los jugadores participantes
+        \pre "pos" contiene, para cada participante, su posición en el ranking, y 'r' tiene
+        el mismo tamaño que "pos"
         \post Se han leído los jugadores que participan en el Torneo y se han almacenado en el vector 'r'
     */
-    void leer_participantes(vector<Jugador>& r, ConjuntoJugadores& jugadores);
+    void leer_participantes(vector<Jugador>& r, const vector<int>& pos, const ConjuntoJugadores& jugadores) const;
 
-    /** @brief Operación de lectura
-        \pre Hay preparados en el canal estándar de entrada una serie de strings que 
-        representan los resultados de los partidos del Torneo leídos en preorden
-        \post 'a' es un arbol de strings con los resultados de los partidos del Torneo
+    /** @brief Operación de lectura de la forma del árbol de resultados
+        \pre "lote" contiene los resultados de los partidos del Torneo en preorden, con "0"
+        en los árboles vacíos
+        \post "der" contiene, para cada resultado de "lote", la posición en "lote" de su 
+        subárbol derecho, o -1 si es un "0"; el subárbol izquierdo siempre es el siguiente
+    */
+    static void leer_resultados(const LoteResultados& lote, vector<int>& der);
+
+    /** @brief Operación de comprobación de los resultados
+        \pre El Torneo está iniciado y "der" es el resultado de <em>leer_resultados</em> sobre "lote"
+        \post El resultado indica si "lote" tiene la misma forma que el cuadro de emparejamientos
+        y todos sus partidos tienen algún set y están decididos según el formato de la Categoria
     */
-    static void leer_resultados(BinTree<string>& a);
+    bool resultados_validos(const LoteResultados& lote, const vector<int>& der) const;
     
     /** @brief Operación de escritura
-        \pre 'a' cuadro de emparejamientos definido correcamente y 'v' contiene los participantes del Torneo
-        \post Se ha escrito a través del canal estándar de salida el cuadro de emparejamientos
+        \pre "pre" y "der" son un cuadro de emparejamientos que da <em>definir_emparejamientos</em>
+        y 'v' contiene los participantes del Torneo
+        \post Se ha escrito a través del canal "os" el cuadro de emparejamientos
     */
-    void imprimir_emparejamientos(const BinTree<int> &a, const vector<Jugador>& v) const;
+    void imprimir_emparejamientos(const vector<int>& pre, const vector<int>& der, const vector<Jugador>& v, ostream& os) const;
     
     /** @brief Operación de escritura
         Se escribe el cuadro de resultados del Torneo
-        \pre 'res' es un BinTree con los resultados del Torneo
-        \post Se ha escrito el cuadro de resultados del Torneo
+        \pre 'a' es el resultado de <em>proc_resultados</em> sobre "lote" y "der"
+        \post Se ha escrito el cuadro de resultados del Torneo a través del canal "os"
     */
-    void imprimir_resultados(const BinTree<int>& a, const BinTree<string>& res) const;
+    void imprimir_resultados(const vector<int>& a, const LoteResultados& lote, const vector<int>& der, ostream& os) const;
     
     /** @brief Operación de escritura
         Se listan los puntos ganados por cada jugador en la última edición del Torneo
         \pre <em>Cierto</em>
-        \post Se ha escrito a través del canal estándar de salida los puntos ganados por cada 
+        \post Se ha escrito a través del canal "os" los puntos ganados por cada 
         jugador en la última edición del Torneo de los jugadores con una puntuación conseguida 
         diferente de 0
     */
-    void listar_puntos() const;
+    void listar_puntos(ostream& os) const;
     
     /** @brief Operación de escritura
         \pre <em>Cierto</em>
-        \post Se ha escrito a través del canal estándar de salida el nombre y la categoria a la que pertenece el Torneo
+        \post Se ha escrito a través del canal "os" el nombre y la categoria a la que pertenece el Torneo
     */
-    void listar_torneo() const;
+    void listar_torneo(ostream& os) const;
 };
 #endif
 
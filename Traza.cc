@@ -0,0 +1,85 @@
+/** @file Traza.cc
+    @brief Código de la clase Traza */
+
+#include "Traza.hh"
+#ifndef NO_DIAGRAM
+#include <atomic>
+#include <iomanip>
+#endif
+using namespace std;
+
+const int Traza::CAPACIDAD;
+
+// Un tramo registrado, con los instantes en nanosegundos desde el origen de la traza
+struct Evento {
+    const char* nombre;
+    long long ini;
+    long long fin;
+};
+
+// Anillo de tramos de un hilo. Solo escribe en el su hilo; "escritos" cuenta todos los
+// tramos que ha registrado, y el que va a continuacion va en escritos % CAPACIDAD
+struct Anillo {
+    Evento ev[Traza::CAPACIDAD];
+    atomic<long long> escritos;
+    int hilo;
+    Anillo* sig;
+};
+
+// Lista de los anillos de todos los hilos que han registrado algun tramo. Los anillos
+// no se liberan nunca, para que se puedan escribir aunque su hilo ya haya acabado
+static atomic<Anillo*> anillos(NULL);
+static atomic<int> num_hilos(0);
+static thread_local Anillo* propio = NULL;
+
+static const chrono::steady_clock::time_point origen = chrono::steady_clock::now();
+
+void Traza::registrar(const char* nom, chrono::steady_clock::time_point ini, chrono::steady_clock::time_point fin) {
+
+    // La primera vez, el hilo crea su anillo y lo añade al principio de la lista
+    if (propio == NULL) {
+        propio = new Anillo;
+        propio->escritos.store(0, memory_order_relaxed);
+        propio->hilo = num_hilos.fetch_add(1, memory_order_relaxed) + 1;
+        propio->sig = anillos.load(memory_order_relaxed);
+        while (not anillos.compare_exchange_weak(propio->sig, propio, memory_order_release, memory_order_relaxed));
+    }
+    long long n = propio->escritos.load(memory_order_relaxed);
+    Evento& e = propio->ev[n % CAPACIDAD];
+    e.nombre = nom;
+    e.ini = chrono::duration_cast<chrono::nanoseconds>(ini - origen).count();
+    e.fin = chrono::duration_cast<chrono::nanoseconds>(fin - origen).count();
+    propio->escritos.store(n + 1, memory_order_release);
+}
+
+bool Traza::compilada() {
+#ifdef TRAZA
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Traza::escribir(ostream& os) {
+    ios::fmtflags formato = os.flags();
+    streamsize precision = os.precision();
+    os << fixed << setprecision(3);
+    os << "{\"traceEvents\":[";
+    bool primero = true;
+    for (Anillo* a = anillos.load(memory_order_acquire); a != NULL; a = a->sig) {
+        long long n = a->escritos.load(memory_order_acquire);
+        long long i = n > CAPACIDAD ? n - CAPACIDAD : 0;
+        for (; i < n; ++i) {
+            const Evento& e = a->ev[i % CAPACIDAD];
+            if (not primero) os << ',';
+            primero = false;
+
+            // Chrome espera los tiempos en microsegundos
+            os << "\n{\"name\":\"" << e.nombre << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << a->hilo
+               << ",\"ts\":" << e.ini/1000.0 << ",\"dur\":" << (e.fin - e.ini)/1000.0 << '}';
+        }
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}" << endl;
+    os.flags(formato);
+    os.precision(precision);
+}
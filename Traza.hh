@@ -0,0 +1,89 @@
+/** @file Traza.hh
+    @brief Especificación de la clase Traza */
+
+#ifndef TRAZA_HH
+#define TRAZA_HH
+
+#ifndef NO_DIAGRAM
+#include <chrono>
+#include <iostream>
+#endif
+using namespace std;
+
+/** @class Traza
+    @brief Registro de los tramos de ejecución de las fases de los comandos.
+    Cada tramo guarda su nombre y los instantes en que empieza y acaba en un anillo
+    propio del hilo que lo ejecuta, así que registrar no necesita ningún mutex ni
+    operación atómica compartida; cuando un anillo se llena se sobrescriben los tramos
+    más antiguos. La traza se escribe en el formato JSON de Chrome (chrome://tracing,
+    Perfetto), con un evento completo por tramo.
+    Los tramos solo se compilan si se define TRAZA (make TRAZA=-DTRAZA); si no, la
+    macro TRAZA_TRAMO no genera ningún código y la traza escrita está vacía.
+*/
+class Traza {
+
+public:
+
+    /** @brief Número de tramos que caben en el anillo de cada hilo */
+    static const int CAPACIDAD = 1 << 15;
+
+    /** @class Tramo
+        @brief Tramo que empieza al construirse y se registra al destruirse */
+    class Tramo {
+
+    private:
+
+        const char* nombre;
+        chrono::steady_clock::time_point ini;
+
+    public:
+
+        /** @brief Creadora
+            \pre "nom" es una cadena que no se libera nunca (un literal)
+            \post Ha empezado un tramo de nombre "nom"
+        */
+        Tramo(const char* nom) {
+            nombre = nom;
+            ini = chrono::steady_clock::now();
+        }
+
+        /** @brief Destructora
+            \pre <em>Cierto</em>
+            \post Se ha registrado el tramo en el anillo del hilo actual
+        */
+        ~Tramo() {
+            registrar(nombre, ini, chrono::steady_clock::now());
+        }
+    };
+
+    /** @brief Se registra un tramo
+        \pre "nom" es una cadena que no se libera nunca, ini <= fin
+        \post Se ha añadido el tramo al anillo del hilo actual
+    */
+    static void registrar(const char* nom, chrono::steady_clock::time_point ini, chrono::steady_clock::time_point fin);
+
+    /** @brief Consultor de si los tramos están compilados
+        \pre <em>Cierto</em>
+        \post El resultado indica si se ha compilado con TRAZA
+    */
+    static bool compilada();
+
+    /** @brief Operación de escritura de la traza
+        \pre Ningún otro hilo está registrando tramos
+        \post Se han escrito a través del canal "os", en formato JSON de Chrome, los
+        tramos que quedan en el anillo de cada hilo
+    */
+    static void escribir(ostream& os);
+};
+
+// El nombre de la variable lleva el numero de linea para poder abrir varios tramos en un mismo bloque
+#define TRAZA_CONCATENAR2(a, b) a##b
+#define TRAZA_CONCATENAR(a, b) TRAZA_CONCATENAR2(a, b)
+
+#ifdef TRAZA
+#define TRAZA_TRAMO(nom) Traza::Tramo TRAZA_CONCATENAR(tramo_, __LINE__)(nom)
+#else
+#define TRAZA_TRAMO(nom)
+#endif
+
+#endif
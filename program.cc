@@ -6,283 +6,156 @@ un circuito de torneos de tenis. */
 /** @file program.cc
     @brief Programa principal para la práctica <em>Circuito de torneos de tenis</em> */
 
-#include "Jugador.hh"
-#include "ConjuntoJugadores.hh"
-#include "Torneo.hh"
-#include "ConjuntoTorneos.hh"
-#include "Categoria.hh"
+#include "Circuito.hh"
+#include "LectorComandos.hh"
+#include "LectorFuentes.hh"
+#include "EscritorBinario.hh"
+#include "ServidorConsultas.hh"
+#include "Traza.hh"
 
 #ifndef NO_DIAGRAM 
+#include <fstream>
+#include <functional>
 #include <iostream>
-#include <vector>
+#include <sstream>
 #include <string>
-#include "BinTree.hh"
-#include "ParInt.hh"
-#include <map>
-#include <cmath>
+#include <thread>
+#include "ColaSPSC.hh"
 #endif
 
 using namespace std;
 
-/** @brief Programa principal para la práctica <em>Circuito de torneos de tenis</em>. */
-
-int main() {
-    
-    // Se lee el numero de categorias
-    int c; 
-    cin >> c;
-    
-    // Se lee el numero maximo de niveles de los torneos
-    int k;
-    cin >> k;
-    
-    // Declaramos un map de categorias con un entero como clave
-    map<int, Categoria> map_cat;
-    
-    // Leemos el nombre de cada una y asignamos el indentificador 
-    // string y el identificador entero en cada categoria
-    string id_cat;
-    for (int i = 1; i <= c; ++i) {
-        cin >> id_cat;
-        Categoria cat(id_cat,i);
-        map_cat.insert(make_pair(i, cat));
-    }
-    
-    // Leemos los puntos pertenecientes a cada nivel de la categoria 
-    // a partir del num. maximo de niveles k
-    map<int, Categoria>::iterator it;
-    for (it = map_cat.begin(); it != map_cat.end(); ++it)  
-        it->second.asignar_puntos(k);
-            
-    // Declaramos y leemos un conjunto de t torneos
-    int t;
-    cin >> t;
-    ConjuntoTorneos torneos(t);
-    torneos.leer_torneos(map_cat);
-    
-    // Declaramos y leemos un conjunto de p jugadores
-    int p;
-    cin >> p;
-    ConjuntoJugadores jugadores(p);
-    jugadores.leer_jugadores();
-    
-    // Procesamiento de comandos
-    string com;
-    cin >> com;
-    while (com != "fin") {
-        
-        if (com == "nuevo_jugador" or com == "nj") {
-
-            string id_p;
-            cin >> id_p;
-            cout << '#' << com << ' ' << id_p << endl;
-            
-            // Si el jugador con identificador id_p no existe, 
-            // añadimos al conjunto de jugadores un jugador 
-            // con identificador id_p
-            if (not jugadores.existe_jugador(id_p)) {
-                jugadores.nuevo_jugador(id_p);
-                cout << jugadores.numero_jugadores() << endl;
-            } else 
-                cout << "error: ya existe un jugador con ese nombre" << endl;
-        } 
-        
-        else if (com == "nuevo_torneo" or com == "nt") {
-
-            string id_to;
-            int ca;
-            cin >> id_to;
-            cin >> ca;
-            cout << '#' << com << ' ' << id_to << ' ' << ca << endl;
-            
-            // Si la categoria "ca" esta entre 1 y c, y no existe el torneo
-            // en el conjunto de torneos, se añade un nuevo torneo con 
-            // el identificador id_to y de categoria ca
-            if (ca < 1 or ca > c) 
-                cout << "error: la categoria no existe" << endl;
-            else if (torneos.existe_torneo(id_to))
-                cout << "error: ya existe un torneo con ese nombre" << endl;
-            else {
-                Categoria catg = map_cat[ca];
-                torneos.nuevo_torneo(id_to, catg);
-                cout << torneos.numero_torneos() << endl;
-            }
-        }
-                
-        else if (com == "baja_jugador" or com == "bj") {
-
-            string id_p;
-            cin >> id_p;
-            cout << '#' << com << ' ' << id_p << endl;
-            
-            // Si existe un jugador con identificador id_p, 
-            // se da de baja del conjunto de jugadores del 
-            // circuito al jugador con identificador id_p
-            if (jugadores.existe_jugador(id_p)) {
-                jugadores.baja_jugador(id_p);
-                cout << jugadores.numero_jugadores() << endl;
-            } else 
-                cout << "error: el jugador no existe" << endl;
-        }
-        
-        else if (com == "baja_torneo" or com == "bt") {
-
-            string id_to;
-            cin >> id_to;
-            cout << '#' << com << ' ' << id_to << endl;
-            
-            // Si existe un torneo con identificador id_to,
-            // se da de baja al torneo con el mismo identificador
-            if (torneos.existe_torneo(id_to)) {
-                Torneo torn = torneos.consultar_torneo(id_to);
-                torn.restar_puntos(jugadores);
-                jugadores.actualizar_ranking();
-                torneos.baja_torneo(id_to);                  
-                cout << torneos.numero_torneos() << endl;
-            } else 
-                cout << "error: el torneo no existe" << endl;
-        }
-        
-        else if (com == "iniciar_torneo" or com == "it") {
-
-            string id_to;
-            cin >> id_to;
-            
-            // Si existe un torneo con identificador id_to
-            // se inicia el torneo con el mismo identificador
-            if (torneos.existe_torneo(id_to)) {
-
-                Torneo torn = torneos.consultar_torneo(id_to);
-
-                // se lee 'n' que representa el num. de participantes 
-                // y se leen n enteros que representan sus posiciones en el ranking
-                // Los participantes se almacenan en el vector 'r'
-                int n;
-                cin >> n; 
-                vector<Jugador> r(n); 
-                torn.leer_participantes(r, jugadores);
-
-                cout << '#' << com << ' ' << id_to << endl;
-
-                // Se calcula 'h', la altura del arbol de emparejamientos
-                int h = ceil(log2(n))+1; 
-
-                // Se calcula 'j' que representa los jugadores (nodos) del nivel h-1 que no tendrán hijos
-                // en el arbol en caso de que el ultimo nivel no este completo
-                int j = pow(2, h-1) - n;
-
-                // Declaramos un arbol de enteros con raíz 1 (ganador)
-                // y a partir de este arbol construimos el arbol de emparejamientos
-                BinTree<int> arb(1);
-                torn.definir_emparejamientos(arb, h, 1, 1, j);
-
-                // Asigna el cuadro de emparejamientos y el vector de participantes
-                // en el torneo contenido en el conjunto de torneos
-                // para poder usar dichos atributos en "finalizar_torneo"
-                torneos.definir_cuadro_y_participantes(id_to,arb,r);
-                
-                // Se imprime el cuadro de emparejamientos
-                torn.imprimir_emparejamientos(arb,r);
-                cout << endl;
-            }
-        }
-        
-        else if (com == "finalizar_torneo" or com == "ft") {
-
-            string id_to;
-            cin >> id_to;
-
-            // Si existe un torneo con identificador id_to se finaliza este torneo
-            if (torneos.existe_torneo(id_to)) {
-
-                Torneo torn = torneos.consultar_torneo(id_to);
-
-                // Se crea arbol de strings con los resultados leidos
-                BinTree<string> res;
-                torn.leer_resultados(res);
-                
-                // "emp" es el cuadro de emparejamientos del torneo
-                BinTree<int> emp = torn.consultar_cuadro();
-                
-                // Se construye el arbol 'a' que representa el cuadro de resultados
-                // del torneo una vez disputados los partidos
-                BinTree<int> a;
-                torn.proc_resultados(a, emp, res);
-
-                cout << '#' << com << ' ' << id_to << endl;
-                
-                // Se imprimen los resultados del torneo
-                torn.imprimir_resultados(a, res);
-                cout << endl;
-                
-                // Se restan los puntos de la edición anterior y se actualizan las estadísticas
-                // de cada jugador
-                torn.restar_puntos(jugadores);
-                torn.actualizar_estadisticas(a, res, 1, jugadores);
-                
-                // Se listan los puntos que ha ganado cada jugador y se asignan los participantes del torneo,
-                // y este se añade al conjunto de torneos
-                torn.listar_puntos();
-                torneos.definir_ult_jugadores(id_to, torn);
-
-                jugadores.actualizar_ranking();
-            }
-        }
-        
-        else if (com == "listar_ranking" or com == "lr") {
-
-            cout << '#' << com << endl;
+/** @brief Capacidad de las colas entre las etapas del modo en tubería */
+const int TAM_COLA = 1024;
+
+/** @brief Etapa de lectura del modo en tubería
+    \pre <em>Cierto</em>
+    \post Se han encolado en "comandos" todos los comandos que ha dado "leer" hasta que
+    ha devuelto falso y se ha cerrado la cola
+*/
+static void leer_comandos(const function<bool(Comando&)>& leer, ColaSPSC<Comando>& comandos) {
+    Comando com;
+    while (leer(com)) comandos.encolar(com);
+    comandos.cerrar();
+}
 
-            // Se lista el ranking perteneciente al conjunto de jugadores
-            jugadores.listar_ranking();
-        }
-        
-        else if (com == "listar_jugadores" or com == "lj") {
+/** @brief Etapa de escritura del modo en tubería
+    \pre <em>Cierto</em>
+    \post Se han escrito en "os", en el orden de la cola, todas las salidas encoladas
+    en "salidas" hasta que se ha cerrado
+*/
+static void escribir_salidas(ColaSPSC<string>& salidas, ostream& os) {
+    string s;
+    while (salidas.desencolar(s)) os.write(s.data(), s.size());
+    os.flush();
+}
 
-            cout << '#' << com << endl;
-            
-            // Se listan los jugadores del conjunto de jugadores
-            jugadores.listar_jugadores();
-        }
-        
-        else if (com == "consultar_jugador" or com == "cj") {
+/** @brief Programa principal para la práctica <em>Circuito de torneos de tenis</em>. 
+    Con la opción <em>--servidor ruta</em> se atienden además consultas de solo lectura
+    a través de un socket local en "ruta" (ver <em>ServidorConsultas</em>).
+    Con la opción <em>--tuberia</em> la lectura de comandos, su ejecución y la escritura de
+    la salida se hacen en tres hilos distintos conectados por colas; la salida es la misma.
+    Con la opción <em>--traza ruta</em> se escribe al acabar en "ruta" la traza de las
+    fases de los comandos en formato JSON de Chrome (ver <em>Traza</em>).
+    Los comandos se pueden dar en texto o en formato binario (ver <em>EscritorBinario</em>).
+    Con la opción <em>--convertir</em> no se ejecuta nada: se convierte la entrada de texto
+    al formato binario y se escribe por el canal de salida.
+    Con la opción <em>--archivo ruta</em> los cuadros de las ediciones finalizadas se
+    guardan en el fichero "ruta", donde se conservan de una ejecución a otra (ver
+    <em>ArchivoCuadros</em>); si no, se guardan solo en memoria.
+    Con la opción <em>--fuente ruta</em>, que se puede repetir, los comandos no se leen del
+    canal de entrada (que solo da los datos iniciales) sino de los ficheros o FIFOs "ruta",
+    cada uno en su hilo. En ellos cada comando va precedido de su número de secuencia, que
+    crece dentro de cada fuente, y se ejecutan en orden de secuencia (ver
+    <em>LectorFuentes</em>). Como no se puede saber el siguiente comando hasta que todas
+    las fuentes han dado alguno o se han acabado, si una fuente es un FIFO que nadie abre
+    para escribir el programa espera indefinidamente. */
+
+int main(int argc, char* argv[]) {
+
+    // Opciones de la linea de comandos
+    string ruta_servidor;
+    bool tuberia = false;
+    string ruta_traza;
+    bool convertir = false;
+    string ruta_archivo;
+    vector<string> rutas_fuentes;
+    for (int i = 1; i < argc; ++i) {
+        string op = argv[i];
+        if (op == "--servidor" and i+1 < argc) ruta_servidor = argv[++i];
+        else if (op == "--tuberia") tuberia = true;
+        else if (op == "--traza" and i+1 < argc) ruta_traza = argv[++i];
+        else if (op == "--convertir") convertir = true;
+        else if (op == "--archivo" and i+1 < argc) ruta_archivo = argv[++i];
+        else if (op == "--fuente" and i+1 < argc) rutas_fuentes.push_back(argv[++i]);
+    }
 
-            string id_p;
-            cin >> id_p;
-            cout << '#' << com << ' ' << id_p << endl;
-            
-            // Si existe un jugador con identificador id_p 
-            // se lista a este jugador
-            if (jugadores.existe_jugador(id_p)) {
-                Jugador jug = jugadores.consultar_jugador(id_p);
-                jug.listar_jugador();
-            } else 
-                cout << "error: el jugador no existe" << endl;
-        }
-        
-        else if (com == "listar_torneos" or com == "lt") {
+    // Si solo se pide la conversion al formato binario, no se ejecuta ningun comando
+    if (convertir) {
+        EscritorBinario::convertir(cin, cout);
+        return 0;
+    }
 
-            // Se listan los torneos del conjunto de torneos
-            cout << '#' << com << endl;
-            torneos.listar_torneos();
+    // Se leen las categorias, los torneos y los jugadores iniciales
+    Circuito circuito;
+    circuito.leer();
+    if (not ruta_archivo.empty() and not circuito.abrir_archivo(ruta_archivo))
+        cerr << "error: no se puede abrir el archivo de cuadros " << ruta_archivo << endl;
+
+    // Si se ha pedido, se publica el estado inicial y se pone en marcha el servidor de consultas
+    ServidorConsultas servidor;
+    if (not ruta_servidor.empty()) {
+        servidor.publicar(circuito.consultar_jugadores(), circuito.consultar_torneos());
+        if (not servidor.iniciar(ruta_servidor)) 
+            cerr << "error: no se puede iniciar el servidor en " << ruta_servidor << endl;
+    }
+    
+    // Procesamiento de comandos, del canal de entrada o de las fuentes, si se han dado
+    LectorComandos lector(cin);
+    LectorFuentes fuentes(rutas_fuentes);
+    function<bool(Comando&)> leer = [&lector, &fuentes, &rutas_fuentes](Comando& com) {
+        return rutas_fuentes.empty() ? lector.leer(com) : fuentes.leer(com);
+    };
+    if (not tuberia) {
+        Comando com;
+        while (leer(com)) {
+            circuito.ejecutar(com, cout);
+
+            // Despues de cada modificacion, los lectores pasan a ver el estado nuevo (dentro
+            // de un lote, al cerrarlo, porque hasta entonces el ranking puede no estar al dia)
+            if (servidor.en_marcha() and com.modifica() and not circuito.hay_lote_abierto()) 
+                servidor.publicar(circuito.consultar_jugadores(), circuito.consultar_torneos());
         }
-        
-        else if (com == "listar_categorias" or com == "lc") {
-
-            cout << '#' << com << endl;
-            cout << c << ' ' << k << endl;
-            
-            // Listamos las categorias del vector vcat inicializado al principio
-            for (it = map_cat.begin(); it != map_cat.end(); ++it) 
-                it->second.listar_categoria(k);
+    } 
+    else {
+
+        // Este hilo ejecuta los comandos que le pasa el de lectura y deja la salida de
+        // cada uno en un buffer propio que el hilo de escritura vuelca en orden
+        ColaSPSC<Comando> comandos(TAM_COLA);
+        ColaSPSC<string> salidas(TAM_COLA);
+        thread lectura(leer_comandos, cref(leer), ref(comandos));
+        thread escritura(escribir_salidas, ref(salidas), ref(cout));
+
+        Comando com;
+        ostringstream os;
+        while (comandos.desencolar(com)) {
+            os.str("");
+            circuito.ejecutar(com, os);
+            if (servidor.en_marcha() and com.modifica() and not circuito.hay_lote_abierto()) 
+                servidor.publicar(circuito.consultar_jugadores(), circuito.consultar_torneos());
+            string s = os.str();
+            if (not s.empty()) salidas.encolar(s);
         }
-        cin >> com;
+        salidas.cerrar();
+        lectura.join();
+        escritura.join();
+    }
+    servidor.detener();
+    if (not ruta_traza.empty()) {
+        if (not Traza::compilada()) 
+            cerr << "aviso: los tramos de traza no estan compilados (make TRAZA=-DTRAZA)" << endl;
+        ofstream fs(ruta_traza);
+        if (fs) Traza::escribir(fs);
+        else cerr << "error: no se puede escribir la traza en " << ruta_traza << endl;
     }
 }
-    
-    
-    
-    
-    
-    
-    
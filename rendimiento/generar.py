@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+# Genera la entrada de la medida de la reordenacion del ranking (ver medir.sh):
+#
+#   generar.py N E
+#
+# N jugadores y E torneos de 8 finalizados uno detras de otro, cada uno con una
+# reordenacion entera del ranking (actualizar_ranking). La entrada se escribe por la
+# salida estandar y siempre es la misma para los mismos argumentos.
+
+import random
+import sys
+
+
+def cuadro(h, l, a, x):
+    if l == h or (l == h - 1 and a <= x):
+        return a
+    b = 2**l + 1 - a
+    return (a, cuadro(h, l + 1, a, x), cuadro(h, l + 1, b, x))
+
+
+def resultados(t):
+    if isinstance(t, int):
+        return ["0"]
+    return [random.choice(["6-0,6-1", "1-6,0-6", "7-5,4-6,6-3"])] + resultados(t[1]) + resultados(t[2])
+
+
+def iniciar_y_finalizar(out, torneo, n, m, h):
+    pos = sorted(random.sample(range(1, n + 1), m))
+    out.append(f"it {torneo} {m} " + " ".join(map(str, pos)))
+    out.append(f"ft {torneo} " + " ".join(resultados(cuadro(h, 1, 1, 2**(h - 1) - m))))
+
+
+def ranking(n, e):
+    out = ["1 4", "C1", "100 50 20 10", "1", "T0 1", str(n)]
+    out.append(" ".join(f"j{i:07d}" for i in range(n)))
+    for i in range(e):
+        out.append(f"nt E{i} 1")
+        iniciar_y_finalizar(out, f"E{i}", n, 8, 4)
+    out.append("fin")
+    return out
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit("uso: generar.py N E")
+    random.seed(1)
+    print("\n".join(ranking(int(sys.argv[1]), int(sys.argv[2]))))
@@ -0,0 +1,54 @@
+#!/bin/bash
+# Compara el tiempo de program.exe del arbol actual con otra version sobre una entrada
+# (ver generar.py). La otra version es el mismo arbol compilado con mas opciones, si
+# se dan opciones, o una revision de git. Por ejemplo, la reordenacion del ranking con
+# radix sort contra la ordenacion por comparacion de antes:
+#
+#   rendimiento/generar.py 2000000 30 > /tmp/ranking.txt
+#   rendimiento/medir.sh /tmp/ranking.txt c40f524
+#
+# Las dos se compilan sin _GLIBCXX_DEBUG, se ejecutan REPETICIONES veces cada una y se
+# escribe el mejor tiempo de cada una. Tambien se comprueba que la salida es la misma.
+
+set -e
+if [ $# -lt 2 ]; then
+    echo "uso: $0 entrada.txt -DOPCION... | REVISION" >&2
+    exit 1
+fi
+entrada=$(realpath "$1")
+shift
+raiz=$(cd "$(dirname "$0")/.." && pwd)
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+REPETICIONES=${REPETICIONES:-3}
+OPCIONS="-D_JUDGE_ -O2 -std=c++17 -pthread -w"
+
+mkdir "$dir/actual" "$dir/otra"
+cp "$raiz"/*.cc "$raiz"/*.hh "$raiz"/Makefile "$dir/actual"
+if [ "${1:0:2}" = "-D" ]; then
+    cp "$raiz"/*.cc "$raiz"/*.hh "$raiz"/Makefile "$dir/otra"
+    extra="$*"
+    nombre="$*"
+else
+    git -C "$raiz" archive "$1" | tar -x -C "$dir/otra"
+    extra=""
+    nombre="$1"
+fi
+make -s -C "$dir/actual" OPCIONS="$OPCIONS" program.exe > /dev/null
+make -s -C "$dir/otra" OPCIONS="$OPCIONS $extra" program.exe > /dev/null
+
+medir() {
+    local mejor=""
+    for i in $(seq "$REPETICIONES"); do
+        local ini=$(date +%s%N)
+        "$1" < "$entrada" > "$2"
+        local t=$(( ($(date +%s%N) - ini) / 1000000 ))
+        if [ -z "$mejor" ] || [ "$t" -lt "$mejor" ]; then mejor=$t; fi
+    done
+    echo "$mejor"
+}
+ta=$(medir "$dir/actual/program.exe" "$dir/actual.out")
+to=$(medir "$dir/otra/program.exe" "$dir/otra.out")
+echo "actual: $ta ms"
+echo "$nombre: $to ms"
+if cmp -s "$dir/actual.out" "$dir/otra.out"; then echo "misma salida"; else echo "salidas distintas"; fi